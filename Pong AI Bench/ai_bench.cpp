@@ -0,0 +1,401 @@
+// Headless AI benchmark.
+// Plays the Expert AI's lookahead on synthetic mid-match states and reports how many
+// rollouts per second the planner gets through with each worker thread count, and how
+// long one plan() takes, next to the raw speed of step_match() on one thread. Run it on
+// the target machine to pick a planning budget the simulation thread can afford.
+// Times IncomingBallQueue's updates, removals and queries with thousands of balls, and
+// checks most_urgent() against a full scan of every ball's arrival.
+// Then times a trained policy (or a random one of the usual shape) with every dot
+// product kernel the CPU runs: one decision at a time, and as a batch simulation of
+// thousands of policy-vs-policy matches stepped together.
+//
+// Usage: "Pong AI Bench" [--seconds <s>] [--max-balls <n>] [--max-threads <n>] [--policy <path>]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include "game_constants.h"
+#include "lookahead_planner.h"
+#include "match_state.h"
+#include "policy_net.h"
+
+using namespace std;
+
+namespace {
+    typedef chrono::steady_clock bench_clock;
+
+    const size_t batch_agents = 4096; // Matches in the batch simulation, two policy agents each
+    const size_t queue_balls = 5000;  // Balls in the IncomingBallQueue runs
+    const size_t queue_checks = 100000; // Random updates and removals in the correctness check
+    const size_t queue_candidates = 15; // How many soonest balls most_urgent() considers
+
+    void report(const string& path, size_t balls, unsigned int threads, double perSecond, double usPerCall) {
+        printf("%-22s %8zu %8u %14.0f %10.3f\n", path.c_str(), balls, threads, perSecond, usPerCall);
+        fflush(stdout);
+    }
+
+    // A mid-match state with the given number of balls, about half of them heading right
+    MatchState make_state(size_t ballCount, mt19937& rng) {
+        uniform_real_distribution<float> x(100.0f, screenwidth - 100.0f);
+        uniform_real_distribution<float> y(0.0f, screenheight - 2 * ballradius);
+        uniform_real_distribution<float> angle(-1.0f, 1.0f);
+
+        MatchState match;
+        match.leftPaddleY = 180.0f;
+        match.rightPaddleY = 320.0f;
+        match.leftScore = 7;
+        match.rightScore = 11;
+        match.ballSpeed = ball_speed_for(3);
+        for (size_t i = 0; i < ballCount; ++i) {
+            BallState ball;
+            ball.x = x(rng);
+            ball.y = y(rng);
+            float a = angle(rng);
+            ball.vx = (i % 2 == 0 ? 1.0f : -1.0f) * cos(a) * match.ballSpeed;
+            ball.vy = sin(a) * match.ballSpeed;
+            match.balls.push_back(ball);
+        }
+        return match;
+    }
+
+    // A policy with random weights and the shape trained policies use: 8-64-64-3
+    bool make_random_policy(PolicyNet& net, mt19937& rng, string& error) {
+        const size_t widths[] = { policy_observation_size, 64, 64, policy_action_count };
+        normal_distribution<float> weight(0.0f, 1.0f);
+        vector<PolicyLayerWeights> layers(3);
+        for (size_t l = 0; l < layers.size(); ++l) {
+            PolicyLayerWeights& layer = layers[l];
+            layer.inputs = widths[l];
+            layer.outputs = widths[l + 1];
+            layer.relu = l + 1 < layers.size();
+            layer.inputScale = (l == 0 ? 1.5f : 6.0f) / 127.0f;
+            for (size_t i = 0; i < layer.inputs * layer.outputs; ++i) {
+                layer.weights.push_back(weight(rng) / sqrt(static_cast<float>(layer.inputs)));
+            }
+            layer.bias.assign(layer.outputs, 0.0f);
+        }
+        vector<char> file;
+        return encode_policy(layers, file, error) && net.load_from_memory(file.data(), file.size(), error);
+    }
+
+    // A ball anywhere on the field, flying at speed in any direction
+    BallState random_ball(mt19937& rng, float speed) {
+        uniform_real_distribution<float> x(100.0f, screenwidth - 100.0f);
+        uniform_real_distribution<float> y(0.0f, screenheight - 2 * ballradius);
+        uniform_real_distribution<float> angle(-3.14159265f, 3.14159265f);
+        BallState ball;
+        ball.x = x(rng);
+        ball.y = y(rng);
+        float a = angle(rng);
+        ball.vx = cos(a) * speed;
+        ball.vy = sin(a) * speed;
+        return ball;
+    }
+
+    // IncomingBallQueue's answer worked out the slow way: every ball's arrival, sorted
+    struct Arrival {
+        uint64_t tick;
+        float y;
+        size_t ball;
+        bool operator<(const Arrival& other) const { return tick < other.tick; }
+    };
+
+    // The centre y most_urgent() should pick, or false if nothing is queued. Among equally
+    // soon balls either may be picked, so the answer is a tick and every y allowed at it.
+    bool brute_force_urgent(const vector<Arrival>& queued, uint64_t now, float paddleCenter, float speed, vector<float>& allowed) {
+        allowed.clear();
+        if (queued.empty()) {
+            return false;
+        }
+        vector<Arrival> sorted = queued;
+        sort(sorted.begin(), sorted.end());
+
+        // The earliest reachable ball of the soonest few (a tie at the cut may let in any of the tied balls)
+        const uint64_t cut = sorted[min(queue_candidates, sorted.size()) - 1].tick;
+        uint64_t pick = 0;
+        bool found = false;
+        for (const Arrival& arrival : sorted) {
+            if (arrival.tick > cut || (found && arrival.tick > pick)) {
+                break;
+            }
+            float distance = abs(arrival.y - paddleCenter) - paddleheight / 2.0f;
+            if (arrival.tick >= now && distance <= speed * (arrival.tick - now)) {
+                pick = arrival.tick;
+                found = true;
+                allowed.push_back(arrival.y);
+            }
+        }
+        if (!found) {
+            for (const Arrival& arrival : sorted) {
+                if (arrival.tick == sorted[0].tick) {
+                    allowed.push_back(arrival.y); // Nothing reachable: the soonest ball
+                }
+            }
+        }
+        return true;
+    }
+
+    float action_offset(PolicyAction action, float speed) {
+        return action == PolicyMoveDown ? speed : (action == PolicyMoveUp ? -speed : 0.0f);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    double seconds = 1.0;
+    size_t maxBalls = 64;
+    unsigned int maxThreads = thread::hardware_concurrency();
+    const char* policyPath = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--max-balls") == 0 && i + 1 < argc) {
+            maxBalls = static_cast<size_t>(atol(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--max-threads") == 0 && i + 1 < argc) {
+            maxThreads = static_cast<unsigned int>(atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--policy") == 0 && i + 1 < argc) {
+            policyPath = argv[++i];
+        }
+    }
+    maxThreads = maxThreads > 0 ? maxThreads : 1;
+
+    printf("%-22s %8s %8s %14s %10s\n", "path", "balls", "threads", "per second", "us/call");
+    mt19937 rng(1234);
+    const LookaheadSettings settings;
+
+    for (size_t balls = 1; balls <= maxBalls; balls *= 8) {
+        const MatchState root = make_state(balls, rng);
+
+        // Raw simulation speed: ticks per second on one thread, restarting from the root at each horizon
+        MatchState match = root;
+        long long ticks = 0;
+        auto start = bench_clock::now();
+        double elapsed = 0.0;
+        do {
+            for (int i = 0; i < settings.horizon; ++i) {
+                step_match(match, 0.0f, 0.0f);
+            }
+            match = root;
+            ticks += settings.horizon;
+            elapsed = chrono::duration<double>(bench_clock::now() - start).count();
+        } while (elapsed < seconds);
+        report("step_match/ticks", balls, 1, ticks / elapsed, 1e6 * elapsed / ticks);
+
+        // The planner: every plan() runs to its budget or its round limit
+        for (unsigned int threads = 1; threads <= maxThreads; threads *= 2) {
+            LookaheadPlanner planner(threads);
+            planner.plan(root, settings); // Starts the worker threads
+            const uint64_t before = planner.get_rollouts();
+            long long plans = 0;
+            start = bench_clock::now();
+            do {
+                planner.plan(root, settings);
+                ++plans;
+                elapsed = chrono::duration<double>(bench_clock::now() - start).count();
+            } while (elapsed < seconds);
+            report("lookahead/rollouts", balls, threads, (planner.get_rollouts() - before) / elapsed, 1e6 * elapsed / plans);
+        }
+    }
+
+    // IncomingBallQueue: re-keying one ball, removing and re-adding one, and a query, with thousands queued
+    {
+        const float planeX = right_paddle_x - 2 * ballradius;
+        const float speed = ball_speed_for(3);
+        IncomingBallQueue queue;
+        vector<BallState> states;
+        for (size_t i = 0; i < queue_balls; ++i) {
+            states.push_back(random_ball(rng, speed));
+            queue.update(i, states[i], planeX, 0, 0.0f);
+        }
+        uniform_int_distribution<size_t> anyBall(0, queue_balls - 1);
+        vector<size_t> picks(4096);
+        for (size_t& pick : picks) {
+            pick = anyBall(rng);
+        }
+
+        long long calls = 0;
+        auto start = bench_clock::now();
+        double elapsed = 0.0;
+        do {
+            for (size_t pick : picks) {
+                states[pick].vx = -states[pick].vx; // A paddle hit
+                queue.update(pick, states[pick], planeX, 0, 0.0f);
+            }
+            calls += picks.size();
+            elapsed = chrono::duration<double>(bench_clock::now() - start).count();
+        } while (elapsed < seconds);
+        report("incoming/update", queue_balls, 1, calls / elapsed, 1e6 * elapsed / calls);
+
+        calls = 0;
+        start = bench_clock::now();
+        do {
+            for (size_t pick : picks) {
+                queue.remove(pick);
+                queue.update(pick, states[pick], planeX, 0, 0.0f);
+            }
+            calls += picks.size();
+            elapsed = chrono::duration<double>(bench_clock::now() - start).count();
+        } while (elapsed < seconds);
+        report("incoming/remove+add", queue_balls, 1, calls / elapsed, 1e6 * elapsed / calls);
+
+        float y = 0.0f;
+        calls = 0;
+        start = bench_clock::now();
+        do {
+            for (size_t i = 0; i < 4096; ++i) {
+                queue.most_urgent(i, 100.0f + (i % 400), 8.0f, y);
+            }
+            calls += 4096;
+            elapsed = chrono::duration<double>(bench_clock::now() - start).count();
+        } while (elapsed < seconds);
+        report("incoming/most_urgent", queue_balls, 1, calls / elapsed, 1e6 * elapsed / calls);
+
+        // Correctness: random re-keys, removals and new balls as time passes, each followed by
+        // a query with a random paddle, checked against brute_force_urgent()
+        IncomingBallQueue checked;
+        vector<Arrival> queued;
+        vector<int> slots(queue_balls, -1); // Index into queued, or -1
+        vector<float> allowed;
+        uniform_real_distribution<float> paddle(paddleheight / 2.0f, screenheight - paddleheight / 2.0f);
+        uniform_int_distribution<int> operation(0, 9);
+        uniform_int_distribution<size_t> fewBalls(0, 199); // Few enough that removals empty it now and then
+        uint64_t now = 0;
+        size_t mismatches = 0;
+        for (size_t step = 0; step < queue_checks; ++step) {
+            now += operation(rng) == 0 ? 50 : 0;
+            size_t ball = fewBalls(rng);
+            BallState state = random_ball(rng, speed);
+            float interceptY, ticks;
+            bool approaching = predict_intercept(state, planeX, interceptY, ticks);
+            bool removal = operation(rng) < 2;
+            if (removal) {
+                checked.remove(ball);
+            }
+            else {
+                checked.update(ball, state, planeX, now, 0.0f); // Drops the ball if it is not approaching
+            }
+
+            if (removal || !approaching) {
+                if (slots[ball] >= 0) {
+                    queued[slots[ball]] = queued.back();
+                    slots[queued.back().ball] = slots[ball];
+                    queued.pop_back();
+                    slots[ball] = -1;
+                }
+            }
+            else {
+                Arrival arrival;
+                arrival.tick = now + static_cast<uint64_t>(ceil(ticks));
+                arrival.y = interceptY + ballradius;
+                arrival.ball = ball;
+                if (slots[ball] < 0) {
+                    slots[ball] = static_cast<int>(queued.size());
+                    queued.push_back(arrival);
+                }
+                else {
+                    queued[slots[ball]] = arrival;
+                }
+            }
+
+            float paddleCenter = paddle(rng);
+            bool expected = brute_force_urgent(queued, now, paddleCenter, 8.0f, allowed);
+            bool found = checked.most_urgent(now, paddleCenter, 8.0f, y);
+            if (found != expected || (found && find(allowed.begin(), allowed.end(), y) == allowed.end())) {
+                ++mismatches;
+            }
+        }
+        if (mismatches > 0) {
+            printf("Error: most_urgent() disagreed with a full scan %zu times in %zu queries\n", mismatches, queue_checks);
+            return -1;
+        }
+        printf("incoming/check: most_urgent() matched a full scan in %zu queries\n", queue_checks);
+
+        // The game only solves balls past get_tracked() as new, so a ball heading away
+        // must still count as seen; otherwise it and every ball after it is re-solved
+        // (with a fresh aim error) every tick instead of only on its events
+        IncomingBallQueue seen;
+        BallState away = random_ball(rng, speed);
+        away.vx = -abs(away.vx);
+        size_t solves = 0;
+        for (uint64_t tick = 0; tick < 100; ++tick) {
+            size_t ballCount = tick < 50 ? 1 : 8; // The serve alone, then more balls join
+            for (size_t i = seen.get_tracked(); i < ballCount; ++i) {
+                bool heading = i == 0 || i == ballCount - 1;
+                seen.update(i, heading ? away : random_ball(rng, speed), planeX, tick, 0.0f);
+                ++solves;
+            }
+        }
+        if (solves != 8) {
+            printf("Error: 8 new balls, some heading away, were solved %zu times over 100 ticks\n", solves);
+            return -1;
+        }
+        printf("incoming/check: a ball heading away counts as tracked\n");
+    }
+
+    PolicyNet policy;
+    string error;
+    if (policyPath ? !policy.load(policyPath, error) : !make_random_policy(policy, rng, error)) {
+        printf("Error: %s\n", error.c_str());
+        return -1;
+    }
+    PolicyBuffers buffers;
+    policy.prepare(buffers);
+
+    // The batch: every match starts from its own shot; both paddles are the policy
+    vector<MatchState> matches;
+    for (size_t i = 0; i < batch_agents; ++i) {
+        matches.push_back(make_state(1, rng));
+    }
+    vector<float> observations(2 * batch_agents * policy_observation_size);
+    vector<PolicyAction> actions(2 * batch_agents);
+    const float speed = 8.0f;
+
+    const PolicyKernel kernels[] = { PolicyKernel::Scalar, PolicyKernel::Sse2, PolicyKernel::Avx2 };
+    for (PolicyKernel kernel : kernels) {
+        if (!set_policy_kernel(kernel)) {
+            continue;
+        }
+        const string name = policy_kernel_name(kernel);
+
+        // One decision: observation and inference, as ai_movement() runs it every tick
+        float observation[policy_observation_size];
+        long long decisions = 0;
+        auto start = bench_clock::now();
+        double elapsed = 0.0;
+        do {
+            for (int i = 0; i < 1000; ++i) {
+                build_observation(matches[i], 1, observation);
+                actions[i] = policy.act(observation, buffers);
+            }
+            decisions += 1000;
+            elapsed = chrono::duration<double>(bench_clock::now() - start).count();
+        } while (elapsed < seconds);
+        report("policy/decision-" + name, 1, 1, decisions / elapsed, 1e6 * elapsed / decisions);
+
+        // The batch simulation: observe every paddle, decide them all in one call, step every match
+        long long ticks = 0;
+        start = bench_clock::now();
+        do {
+            for (size_t i = 0; i < batch_agents; ++i) {
+                build_observation(matches[i], 0, &observations[(2 * i) * policy_observation_size]);
+                build_observation(matches[i], 1, &observations[(2 * i + 1) * policy_observation_size]);
+            }
+            policy.act_batch(observations.data(), 2 * batch_agents, actions.data(), buffers);
+            for (size_t i = 0; i < batch_agents; ++i) {
+                step_match(matches[i], action_offset(actions[2 * i], speed), action_offset(actions[2 * i + 1], speed));
+            }
+            ++ticks;
+            elapsed = chrono::duration<double>(bench_clock::now() - start).count();
+        } while (elapsed < seconds);
+        report("policy/batch-" + name, 1, 1, 2 * batch_agents * ticks / elapsed, 1e6 * elapsed / ticks);
+    }
+    return 0;
+}
@@ -0,0 +1,373 @@
+// Headless tuner for the AI's difficulty table.
+// Plays each difficulty's parameters (speed, reactionMargin, predictionError and
+// reactionTime) against three reference opponents, modelled human players of rising
+// skill, in headless matches run in parallel, and evolves them with a genetic algorithm
+// until the share of points the AI wins against each opponent is close to that
+// difficulty's targets. Then writes the Easy, Medium and Hard rows of ai_parameters()
+// to ai_parameters.inc, which paddle_ai.cpp includes; run it from the game's folder or
+// pass --out.
+//
+// Usage: "Pong AI Tuner" [--population <n>] [--generations <n>] [--points <n>] [--threads <n>] [--seed <n>] [--out <path>]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "game_constants.h"
+#include "match_state.h"
+#include "paddle_ai.h"
+
+using namespace std;
+
+namespace {
+    // A modelled player: re-aims a while after every bounce (give or take reaction_jitter),
+    // and misjudges by up to aimError pixels
+    struct ReferenceOpponent {
+        const char* name;
+        int reactionTicks;
+        float aimError;
+    };
+
+    const ReferenceOpponent reference_opponents[] = {
+        { "novice", 175, 180.0f }, // Misses about 38% of returns against a perfect paddle
+        { "casual", 125, 130.0f }, // About 27%
+        { "skilled", 75, 95.0f },  // About 14%
+    };
+    const size_t opponent_count = sizeof(reference_opponents) / sizeof(reference_opponents[0]);
+
+    // Share of points the AI should win against each reference opponent. Each level is
+    // an even match for one of them, and the levels are a clear step apart.
+    const char* const level_names[] = { "Easy", "Medium", "Hard" };
+    const size_t level_count = 3;
+    const double target_shares[level_count][opponent_count] = {
+        { 0.50, 0.30, 0.15 }, // Easy
+        { 0.70, 0.50, 0.30 }, // Medium
+        { 0.85, 0.70, 0.50 }, // Hard
+    };
+
+    // The genes are the AiParameters fields, each scaled to [0, 1] over its range
+    const size_t gene_count = 4;
+    const float gene_low[gene_count] = { 2.0f, 0.0f, 0.0f, 0.0f };
+    const float gene_high[gene_count] = { 10.0f, 60.0f, 150.0f, 0.05f };
+
+    const float reaction_jitter = 0.3f;             // Reference opponents react up to this much faster or slower
+    const int max_rally_ticks = 60 * sim_tickrate; // A rally this long is called a draw
+    const size_t elite_count = 4;                   // Carried over unchanged every generation
+    const size_t tournament_size = 3;
+    const float blend_margin = 0.25f;               // Children may land this far outside their parents
+    const float mutation_rate = 0.25f;              // Chance each gene mutates
+    const size_t final_points_factor = 4;           // The elites' final re-evaluation plays this many times more points
+
+    struct Individual {
+        float genes[gene_count];
+        double shares[opponent_count];
+        double error; // Mean squared distance from the targets
+    };
+
+    // Parameters as the table can hold them: rounded to what is written out, and the
+    // reaction time to whole ticks
+    AiParameters to_parameters(const float* genes) {
+        float values[gene_count];
+        for (size_t g = 0; g < gene_count; ++g) {
+            values[g] = gene_low[g] + genes[g] * (gene_high[g] - gene_low[g]);
+        }
+        AiParameters ai;
+        ai.speed = round(values[0] * 10.0f) / 10.0f;
+        ai.reactionMargin = round(values[1]);
+        ai.predictionError = round(values[2]);
+        ai.reactionTime = round(values[3] * sim_tickrate) / sim_tickrate;
+        return ai;
+    }
+
+    void to_genes(const AiParameters& ai, float* genes) {
+        const float values[gene_count] = { ai.speed, ai.reactionMargin, ai.predictionError, ai.reactionTime };
+        for (size_t g = 0; g < gene_count; ++g) {
+            genes[g] = min(max((values[g] - gene_low[g]) / (gene_high[g] - gene_low[g]), 0.0f), 1.0f);
+        }
+    }
+
+    // The right paddle as ai_movement() plays it with one ball
+    float tuned_offset(AiController& controller, const MatchState& match, int tick) {
+        if (!controller.ready(tick)) {
+            return 0.0f;
+        }
+        controller.aim(tick, match.rightPaddleY, match.balls[0], 1, right_paddle_x - 2 * ballradius);
+        return controller.steer(match.rightPaddleY);
+    }
+
+    // The left paddle as a reference opponent plays it, at the difficulty's player paddle speed
+    class ReferencePaddle {
+    public:
+        ReferencePaddle(const ReferenceOpponent& opponent, float paddleSpeed, uint32_t seed)
+            : profile(opponent), speed(paddleSpeed), rngState(seed ? seed : 1u) {}
+
+        float offset(const MatchState& match, int tick) {
+            // A bounce or a goal changes the trajectory; the player catches up reactionTicks later
+            const BallState& ball = match.balls[0];
+            if ((ball.vx > 0.0f) != (last.vx > 0.0f) || (ball.vy > 0.0f) != (last.vy > 0.0f) || (ball.x - last.x) * ball.vx < 0.0f) {
+                aimTick = tick + static_cast<int>(profile.reactionTicks * (1.0f + reaction_jitter * xorshift_signed(rngState)));
+            }
+            last = ball;
+
+            if (tick == aimTick) {
+                float y, ticks;
+                targetY = predict_intercept(ball, left_paddle_x + paddlewidth, y, ticks)
+                    ? y + ballradius + profile.aimError * xorshift_signed(rngState)
+                    : screenheight / 2.0f;
+            }
+
+            float center = match.leftPaddleY + paddleheight / 2.0f;
+            if (center < targetY - speed) {
+                return speed;
+            }
+            return center > targetY + speed ? -speed : 0.0f;
+        }
+
+    private:
+        const ReferenceOpponent& profile;
+        float speed;
+        uint32_t rngState; // xorshift32 state
+        BallState last;
+        int aimTick = 0;
+        float targetY = screenheight / 2.0f;
+    };
+
+    // Puts the ball in the centre heading for a random corner, like initialize_game()
+    void serve_ball(MatchState& match, uint32_t& rngState) {
+        BallState& ball = match.balls[0];
+        ball.x = screenwidth / 2.0f - ballradius;
+        ball.y = screenheight / 2.0f - ballradius;
+        ball.vx = xorshift_signed(rngState) < 0.0f ? -match.ballSpeed : match.ballSpeed;
+        ball.vy = xorshift_signed(rngState) < 0.0f ? -match.ballSpeed : match.ballSpeed;
+    }
+
+    // Plays points of the AI against each reference opponent and scores the shares it won.
+    // The ball always flies at 45 degrees, so a match that keeps re-serving the same way
+    // falls into a cycle; every point here is served in a random direction instead.
+    // Every individual evaluated with the same seed sees the same serves and the same
+    // opponent draws, so their differences are down to their parameters.
+    void evaluate(Individual& individual, size_t level, size_t points, uint32_t seed) {
+        const AiParameters ai = to_parameters(individual.genes);
+        const int difficulty = static_cast<int>(level);
+        individual.error = 0.0;
+
+        for (size_t o = 0; o < opponent_count; ++o) {
+            uint32_t serve = seed ^ static_cast<uint32_t>(o + 1) * 0x9E3779B9u;
+            MatchState match;
+            match.leftPaddleY = match.rightPaddleY = screenheight / 2 - paddleheight / 2;
+            match.ballSpeed = ball_speed_for(difficulty);
+            match.balls.resize(1);
+            serve_ball(match, serve);
+
+            AiController right(serve * 0x2545F491u);
+            right.reset(ai);
+            ReferencePaddle left(reference_opponents[o], player_paddle_speed_for(difficulty), serve * 0x6C8E9CF5u);
+            double won = 0.0;
+            size_t played = 0;
+            int rallyStart = 0;
+            for (int tick = 0; played < points; ++tick) {
+                int events = step_match(match, left.offset(match, tick), tuned_offset(right, match, tick));
+                bool scored = (events & (LeftScored | RightScored)) != 0;
+                if (scored || tick - rallyStart >= max_rally_ticks) {
+                    won += scored ? ((events & RightScored) ? 1.0 : 0.0) : 0.5;
+                    ++played;
+                    rallyStart = tick;
+                    serve_ball(match, serve);
+                }
+            }
+
+            individual.shares[o] = won / points;
+            double miss = individual.shares[o] - target_shares[level][o];
+            individual.error += miss * miss / opponent_count;
+        }
+    }
+
+    // Evaluates everyone on worker threads, each taking the next unevaluated individual
+    void evaluate_all(vector<Individual>& population, size_t level, size_t points, uint32_t seed, unsigned int threads) {
+        atomic<size_t> next(0);
+        auto work = [&] {
+            for (size_t i = next.fetch_add(1); i < population.size(); i = next.fetch_add(1)) {
+                evaluate(population[i], level, points, seed);
+            }
+        };
+        vector<thread> workers;
+        for (unsigned int t = 1; t < threads; ++t) {
+            workers.emplace_back(work);
+        }
+        work();
+        for (thread& worker : workers) {
+            worker.join();
+        }
+    }
+
+    bool better(const Individual& a, const Individual& b) {
+        return a.error < b.error;
+    }
+
+    const Individual& tournament(const vector<Individual>& population, mt19937& rng) {
+        uniform_int_distribution<size_t> pick(0, population.size() - 1);
+        const Individual* best = &population[pick(rng)];
+        for (size_t i = 1; i < tournament_size; ++i) {
+            const Individual& other = population[pick(rng)];
+            best = better(other, *best) ? &other : best;
+        }
+        return *best;
+    }
+
+    void describe(const Individual& individual, size_t level) {
+        const AiParameters ai = to_parameters(individual.genes);
+        printf("speed %4.1f  margin %3.0f  error %3.0f  reaction %.3f s  |", ai.speed, ai.reactionMargin, ai.predictionError, ai.reactionTime);
+        for (size_t o = 0; o < opponent_count; ++o) {
+            printf(" %s %.2f/%.2f", reference_opponents[o].name, individual.shares[o], target_shares[level][o]);
+        }
+        printf("  | rms %.3f\n", sqrt(individual.error));
+        fflush(stdout);
+    }
+
+    // Evolves one level's parameters, starting from the current table row
+    Individual tune(size_t level, size_t populationSize, size_t generations, size_t points, unsigned int threads, mt19937& rng) {
+        uniform_real_distribution<float> unit(0.0f, 1.0f);
+        uniform_real_distribution<float> blend(-blend_margin, 1.0f + blend_margin);
+        normal_distribution<float> gaussian(0.0f, 1.0f);
+
+        vector<Individual> population(populationSize);
+        to_genes(ai_parameters(static_cast<int>(level)), population[0].genes);
+        for (size_t i = 1; i < populationSize; ++i) {
+            for (float& gene : population[i].genes) {
+                gene = unit(rng);
+            }
+        }
+
+        vector<Individual> children(populationSize);
+        for (size_t generation = 0; generation < generations; ++generation) {
+            // A fresh seed per generation, so no individual is fitted to one set of serves
+            evaluate_all(population, level, points, rng(), threads);
+            sort(population.begin(), population.end(), better);
+            printf("%-6s %3zu/%zu  ", level_names[level], generation + 1, generations);
+            describe(population[0], level);
+
+            // Elites stay; the rest are blended from tournament winners and mutated, less as the run goes on
+            const float sigma = 0.15f * (1.0f - static_cast<float>(generation) / generations) + 0.02f;
+            for (size_t i = 0; i < populationSize; ++i) {
+                if (i < elite_count) {
+                    children[i] = population[i];
+                    continue;
+                }
+                const Individual& a = tournament(population, rng);
+                const Individual& b = tournament(population, rng);
+                for (size_t g = 0; g < gene_count; ++g) {
+                    float gene = a.genes[g] + blend(rng) * (b.genes[g] - a.genes[g]);
+                    if (unit(rng) < mutation_rate) {
+                        gene += sigma * gaussian(rng);
+                    }
+                    children[i].genes[g] = min(max(gene, 0.0f), 1.0f);
+                }
+            }
+            population.swap(children);
+        }
+
+        // The elites again, on more points and new serves; the best of them wins
+        population.resize(min(elite_count, population.size()));
+        evaluate_all(population, level, points * final_points_factor, rng(), threads);
+        return *min_element(population.begin(), population.end(), better);
+    }
+
+    bool write_table(const string& path, const Individual* best, size_t generations, size_t populationSize, string& error) {
+        FILE* file = fopen(path.c_str(), "w");
+        if (!file) {
+            error = "cannot write " + path;
+            return false;
+        }
+        fprintf(file, "// Easy, Medium and Hard rows of ai_parameters(), written by Pong AI Tuner (%zu generations of %zu).\n", generations, populationSize);
+        fprintf(file, "// Share of points won against each reference opponent, and the target:\n");
+        for (size_t level = 0; level < level_count; ++level) {
+            fprintf(file, "//   %-6s", level_names[level]);
+            for (size_t o = 0; o < opponent_count; ++o) {
+                fprintf(file, "  %s %.2f/%.2f", reference_opponents[o].name, best[level].shares[o], target_shares[level][o]);
+            }
+            fprintf(file, "\n");
+        }
+        for (size_t level = 0; level < level_count; ++level) {
+            const AiParameters ai = to_parameters(best[level].genes);
+            fprintf(file, "        { %.1ff, %.1ff, %.1ff, %.3ff }, // %s\n", ai.speed, ai.reactionMargin, ai.predictionError, ai.reactionTime, level_names[level]);
+        }
+        bool written = ferror(file) == 0;
+        written = fclose(file) == 0 && written;
+        if (!written) {
+            error = "cannot write " + path;
+        }
+        return written;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    size_t populationSize = 64;
+    size_t generations = 30;
+    size_t points = 200;
+    unsigned int threads = thread::hardware_concurrency();
+    uint32_t seed = 1234;
+    string outPath = "ai_parameters.inc";
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--population") == 0 && i + 1 < argc) {
+            populationSize = static_cast<size_t>(atol(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--generations") == 0 && i + 1 < argc) {
+            generations = static_cast<size_t>(atol(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--points") == 0 && i + 1 < argc) {
+            points = static_cast<size_t>(atol(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = static_cast<unsigned int>(atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        }
+        else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            outPath = argv[++i];
+        }
+    }
+    threads = threads > 0 ? threads : 1;
+    populationSize = max(populationSize, elite_count + 1);
+    generations = max<size_t>(generations, 1);
+    points = max<size_t>(points, 1);
+
+    // Where the current table stands
+    printf("Current table, %zu points per opponent:\n", points * final_points_factor);
+    for (size_t level = 0; level < level_count; ++level) {
+        vector<Individual> current(1);
+        to_genes(ai_parameters(static_cast<int>(level)), current[0].genes);
+        evaluate_all(current, level, points * final_points_factor, seed, 1);
+        printf("%-6s          ", level_names[level]);
+        describe(current[0], level);
+    }
+
+    mt19937 rng(seed);
+    Individual best[level_count];
+    auto start = chrono::steady_clock::now();
+    for (size_t level = 0; level < level_count; ++level) {
+        best[level] = tune(level, populationSize, generations, points, threads, rng);
+    }
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    printf("Tuned in %.1f s on %u threads:\n", elapsed, threads);
+    for (size_t level = 0; level < level_count; ++level) {
+        printf("%-6s          ", level_names[level]);
+        describe(best[level], level);
+    }
+
+    string error;
+    if (!write_table(outPath, best, generations, populationSize, error)) {
+        printf("Error: %s\n", error.c_str());
+        return -1;
+    }
+    printf("Wrote %s\n", outPath.c_str());
+    return 0;
+}
@@ -0,0 +1,28 @@
+// Build step that packs the game's loose assets into one bundle.
+// The game project runs it after every build, writing pong_assets.pak next to
+// the executable; see asset_bundle.h for the file layout.
+//
+// Usage: "Pong Asset Packer" <bundle> <file>...
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "asset_bundle.h"
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        printf("Usage: %s <bundle> <file>...\n", argv[0]);
+        return 1;
+    }
+
+    vector<string> files(argv + 2, argv + argc);
+    string error;
+    if (!write_asset_bundle(argv[1], files, error)) {
+        printf("Error: %s\n", error.c_str());
+        return 1;
+    }
+    printf("Packed %zu assets into %s\n", files.size(), argv[1]);
+    return 0;
+}
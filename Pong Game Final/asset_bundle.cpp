@@ -0,0 +1,212 @@
+#include "asset_bundle.h"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+    size_t align_up(size_t offset) {
+        return (offset + bundle_alignment - 1) / bundle_alignment * bundle_alignment;
+    }
+
+    // Everything after the last path separator
+    string file_name_of(const string& path) {
+        size_t slash = path.find_last_of("/\\");
+        return slash == string::npos ? path : path.substr(slash + 1);
+    }
+}
+
+AssetBundle::~AssetBundle() {
+    close();
+}
+
+bool AssetBundle::open(const string& path) {
+    close();
+
+#ifdef _WIN32
+    HANDLE fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(fileHandle);
+        return false;
+    }
+    HANDLE mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void* view = mappingHandle ? MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        if (mappingHandle) {
+            CloseHandle(mappingHandle);
+        }
+        CloseHandle(fileHandle);
+        return false;
+    }
+    file = fileHandle;
+    mapping = mappingHandle;
+    length = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+    length = static_cast<size_t>(info.st_size);
+    void* view = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // The mapping keeps the file alive
+    if (view == MAP_FAILED) {
+        length = 0;
+        return false;
+    }
+#endif
+    base = static_cast<const unsigned char*>(view);
+
+    // Validate the header and every index entry once, so find() can trust them
+    const BundleHeader* header = reinterpret_cast<const BundleHeader*>(base);
+    bool valid = length >= sizeof(BundleHeader)
+        && memcmp(header->magic, bundle_magic, sizeof(bundle_magic)) == 0
+        && header->version == bundle_version
+        && header->count <= (length - sizeof(BundleHeader)) / sizeof(BundleEntry);
+    if (valid) {
+        entries = reinterpret_cast<const BundleEntry*>(base + sizeof(BundleHeader));
+        count = header->count;
+        for (uint32_t i = 0; i < count && valid; ++i) {
+            const BundleEntry& entry = entries[i];
+            valid = memchr(entry.name, '\0', bundle_name_length) != nullptr
+                && entry.offset <= length && entry.size <= length - entry.offset;
+        }
+    }
+    if (!valid) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void AssetBundle::close() {
+    if (base) {
+#ifdef _WIN32
+        UnmapViewOfFile(base);
+        CloseHandle(static_cast<HANDLE>(mapping));
+        CloseHandle(static_cast<HANDLE>(file));
+        mapping = file = nullptr;
+#else
+        munmap(const_cast<unsigned char*>(base), length);
+#endif
+    }
+    base = nullptr;
+    length = 0;
+    entries = nullptr;
+    count = 0;
+}
+
+bool AssetBundle::find(const char* name, AssetView& view) const {
+    for (uint32_t i = 0; i < count; ++i) { // A handful of entries; a linear scan is plenty
+        if (strcmp(entries[i].name, name) == 0) {
+            view.data = base + entries[i].offset;
+            view.size = static_cast<size_t>(entries[i].size);
+            return true;
+        }
+    }
+    return false;
+}
+
+string executable_directory(const char* argv0) {
+    string path;
+#ifdef _WIN32
+    char buffer[MAX_PATH];
+    DWORD written = GetModuleFileNameA(nullptr, buffer, MAX_PATH);
+    if (written > 0 && written < MAX_PATH) {
+        path.assign(buffer, written);
+    }
+#else
+    char buffer[4096];
+    ssize_t written = readlink("/proc/self/exe", buffer, sizeof(buffer));
+    if (written > 0 && static_cast<size_t>(written) < sizeof(buffer)) {
+        path.assign(buffer, static_cast<size_t>(written));
+    }
+#endif
+    if (path.empty() && argv0) {
+        path = argv0; // No /proc (e.g. macOS): fall back to how we were started
+    }
+    size_t slash = path.find_last_of("/\\");
+    return slash == string::npos ? string() : path.substr(0, slash + 1);
+}
+
+bool write_asset_bundle(const string& path, const vector<string>& files, string& error) {
+    // Read everything first so a missing input never leaves a half-written bundle behind
+    vector<BundleEntry> index(files.size());
+    vector<vector<char>> blobs(files.size());
+    size_t offset = align_up(sizeof(BundleHeader) + files.size() * sizeof(BundleEntry));
+    for (size_t i = 0; i < files.size(); ++i) {
+        string name = file_name_of(files[i]);
+        if (name.empty() || name.size() >= bundle_name_length) {
+            error = "Asset name must be 1 to " + to_string(bundle_name_length - 1) + " characters: " + files[i];
+            return false;
+        }
+        for (size_t j = 0; j < i; ++j) {
+            if (name == index[j].name) {
+                error = "Two assets are named " + name;
+                return false;
+            }
+        }
+
+        ifstream input(files[i], ios::binary);
+        if (!input) {
+            error = "Could not open " + files[i];
+            return false;
+        }
+        blobs[i].assign(istreambuf_iterator<char>(input), istreambuf_iterator<char>());
+
+        BundleEntry& entry = index[i];
+        memset(&entry, 0, sizeof(entry));
+        memcpy(entry.name, name.c_str(), name.size());
+        entry.offset = offset;
+        entry.size = blobs[i].size();
+        offset = align_up(offset + blobs[i].size());
+    }
+
+    ofstream output(path, ios::binary | ios::trunc);
+    if (!output) {
+        error = "Could not create " + path;
+        return false;
+    }
+    BundleHeader header;
+    memcpy(header.magic, bundle_magic, sizeof(bundle_magic));
+    header.version = bundle_version;
+    header.count = static_cast<uint32_t>(files.size());
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!index.empty()) {
+        output.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(BundleEntry));
+    }
+
+    // Zero padding up to each blob's aligned offset
+    const char padding[bundle_alignment] = {};
+    size_t written = sizeof(BundleHeader) + index.size() * sizeof(BundleEntry);
+    for (size_t i = 0; i < blobs.size(); ++i) {
+        output.write(padding, static_cast<streamsize>(index[i].offset - written));
+        output.write(blobs[i].data(), static_cast<streamsize>(blobs[i].size()));
+        written = static_cast<size_t>(index[i].offset + index[i].size);
+    }
+    if (!output) {
+        error = "Could not write " + path;
+        return false;
+    }
+    return true;
+}
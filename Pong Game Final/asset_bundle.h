@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Packed asset bundle ("pong_assets.pak"), built by the Pong Asset Packer project.
+// Layout, little-endian:
+//   BundleHeader
+//   BundleEntry[count]              (the index)
+//   blobs, each starting on a bundle_alignment boundary
+// The game maps the whole file read-only and hands each blob to SFML in place.
+
+const char bundle_magic[8] = { 'P', 'O', 'N', 'G', 'P', 'A', 'K', '1' };
+const uint32_t bundle_version = 1;
+const size_t bundle_alignment = 64;   // Blob start alignment within the file
+const size_t bundle_name_length = 48; // Including the terminating zero
+const char bundle_file_name[] = "pong_assets.pak";
+
+struct BundleHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t count;    // Index entries that follow the header
+};
+
+struct BundleEntry {
+    char name[bundle_name_length]; // File name the asset was packed from, e.g. "Arial.ttf"
+    uint64_t offset;               // From the start of the file
+    uint64_t size;                 // Bytes
+};
+
+// A read-only slice of a mapped bundle; valid while the bundle stays open
+struct AssetView {
+    const void* data = nullptr;
+    size_t size = 0;
+};
+
+// A bundle file mapped into memory. Lookups return pointers into the mapping, so
+// nothing is read or copied until SFML touches the pages. Fonts and music keep
+// reading from their memory while they are in use, so the bundle must outlive them.
+class AssetBundle {
+public:
+    AssetBundle() = default;
+    ~AssetBundle();
+    AssetBundle(const AssetBundle&) = delete;
+    AssetBundle& operator=(const AssetBundle&) = delete;
+
+    bool open(const std::string& path); // Maps and validates the file; false if it is missing or malformed
+    void close();
+    bool is_open() const { return base != nullptr; }
+
+    bool find(const char* name, AssetView& view) const; // false if the bundle has no such asset
+
+private:
+    const unsigned char* base = nullptr; // Start of the mapping
+    size_t length = 0;
+    const BundleEntry* entries = nullptr;
+    uint32_t count = 0;
+#ifdef _WIN32
+    void* file = nullptr;    // HANDLEs
+    void* mapping = nullptr;
+#endif
+};
+
+// Directory of the running executable with a trailing separator ("" if unknown),
+// so assets are found however the game was started
+std::string executable_directory(const char* argv0);
+
+// Packs the given files into a bundle at path, naming each asset after its file name.
+// On failure returns false and describes the problem in error.
+bool write_asset_bundle(const std::string& path, const std::vector<std::string>& files, std::string& error);
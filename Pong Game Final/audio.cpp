@@ -0,0 +1,96 @@
+#include "audio.h"
+#include <SFML/Audio/InputSoundFile.hpp>
+#include <new>
+#include "logger.h"
+#include "music_stream.h"
+
+using namespace std;
+using namespace sf;
+
+namespace {
+    const size_t effect_voices = 32;
+
+    bool decode_all(InputSoundFile& file, SoundSamples& sound) {
+        sound.channelCount = file.getChannelCount();
+        sound.sampleRate = file.getSampleRate();
+        sound.samples.resize(static_cast<size_t>(file.getSampleCount()));
+        sound.samples.resize(static_cast<size_t>(file.read(sound.samples.data(), sound.samples.size())));
+        return !sound.samples.empty();
+    }
+}
+
+bool decode_sound(const void* data, size_t size, SoundSamples& sound) {
+    InputSoundFile file;
+    return file.openFromMemory(data, size) && decode_all(file, sound);
+}
+
+bool decode_sound(const string& path, SoundSamples& sound) {
+    InputSoundFile file;
+    return file.openFromFile(path) && decode_all(file, sound);
+}
+
+OpenAlAudio::OpenAlAudio() {
+}
+
+OpenAlAudio::~OpenAlAudio() {
+    if (mixer) {
+        mixer->~SoundMixer();
+    }
+}
+
+MusicStream& OpenAlAudio::get_music() {
+    if (!music) {
+        music.reset(new MusicStream());
+    }
+    return *music;
+}
+
+bool OpenAlAudio::open_music(const void* data, size_t size) {
+    return get_music().open_from_memory(data, size);
+}
+
+bool OpenAlAudio::open_music(const string& path) {
+    return get_music().open_from_file(path);
+}
+
+void OpenAlAudio::play_music(float volume) {
+    MusicStream& stream = get_music();
+    stream.set_looping(true);
+    stream.setVolume(volume);
+    stream.play();
+}
+
+int OpenAlAudio::add_effect(const SoundSamples& sound) {
+    if (mixer || sound.samples.empty() || sound.channelCount == 0) {
+        return -1;
+    }
+    pendingEffects.push_back(sound);
+    return static_cast<int>(pendingEffects.size() - 1);
+}
+
+void OpenAlAudio::start_effects() {
+    if (mixer) {
+        return;
+    }
+    mixer = new (mixerStorage) SoundMixer(effect_voices);
+    for (const SoundSamples& sound : pendingEffects) {
+        mixer->add_sound(sound.samples.data(), sound.samples.size(), sound.channelCount, sound.sampleRate); // Ids match add_effect()'s
+    }
+    pendingEffects.clear();
+    mixer->play();
+}
+
+void OpenAlAudio::play_effect(int effect, float gain, float pitch, float pan) {
+    if (mixer) {
+        mixer->trigger(effect, gain, pitch, pan);
+    }
+}
+
+void OpenAlAudio::log_stats() const {
+    if (music && music->get_underruns() > 0) {
+        LOG_WARNING("Music decoder fell behind %llu times", static_cast<unsigned long long>(music->get_underruns()));
+    }
+    if (mixer && mixer->get_stolen_voices() > 0) {
+        LOG_INFO("Sound mixer: %llu voices cut off to make room", static_cast<unsigned long long>(mixer->get_stolen_voices()));
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <SFML/Config.hpp>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include "sound_mixer.h"
+
+class MusicStream;
+
+// A sound effect decoded into memory. Decoding goes through sf::InputSoundFile,
+// which never touches the audio device.
+struct SoundSamples {
+    std::vector<sf::Int16> samples; // Interleaved
+    unsigned int channelCount = 0;
+    unsigned int sampleRate = 0;
+};
+
+bool decode_sound(const void* data, std::size_t size, SoundSamples& sound);
+bool decode_sound(const std::string& path, SoundSamples& sound);
+
+// Everything the game plays: looping background music and mixed sound effects.
+// Music may be opened and started from a loading thread while effects are set up
+// and triggered from the render thread.
+class AudioBackend {
+public:
+    virtual ~AudioBackend() {}
+
+    virtual bool open_music(const void* data, std::size_t size) = 0; // Decoded in place; the data must outlive the backend
+    virtual bool open_music(const std::string& path) = 0;
+    virtual void play_music(float volume) = 0;                        // Loops; volume 0 to 100
+
+    virtual int add_effect(const SoundSamples& sound) = 0;           // Before start_effects(); returns the effect's id, or -1
+    virtual void start_effects() = 0;
+    virtual void play_effect(int effect, float gain, float pitch, float pan) = 0; // Any one thread; never blocks
+
+    virtual void log_stats() const = 0; // Underruns and stolen voices, if there were any
+};
+
+// Plays through OpenAL. The device is only opened when the music is opened or
+// the effects are started, not when the backend (or a sound) is created.
+class OpenAlAudio : public AudioBackend {
+public:
+    OpenAlAudio();
+    ~OpenAlAudio();
+
+    bool open_music(const void* data, std::size_t size) override;
+    bool open_music(const std::string& path) override;
+    void play_music(float volume) override;
+
+    int add_effect(const SoundSamples& sound) override;
+    void start_effects() override;
+    void play_effect(int effect, float gain, float pitch, float pan) override;
+
+    void log_stats() const override;
+
+private:
+    MusicStream& get_music(); // Creates the stream (and so the device) on first use
+
+    std::unique_ptr<MusicStream> music;
+    std::vector<SoundSamples> pendingEffects; // Added before the mixer exists
+
+    // The mixer is built in place by start_effects(): it is 64-byte aligned, which
+    // a C++14 heap allocation does not guarantee. So OpenAlAudio lives on the stack.
+    alignas(SoundMixer) unsigned char mixerStorage[sizeof(SoundMixer)];
+    SoundMixer* mixer = nullptr;
+};
+
+// Accepts every call and does nothing: for headless runs, benchmarks and
+// machines without an audio device. Nothing in it touches OpenAL.
+class NullAudio : public AudioBackend {
+public:
+    bool open_music(const void* /*data*/, std::size_t /*size*/) override { return true; }
+    bool open_music(const std::string& /*path*/) override { return true; }
+    void play_music(float /*volume*/) override {}
+
+    int add_effect(const SoundSamples& /*sound*/) override { return effects++; }
+    void start_effects() override {}
+    void play_effect(int /*effect*/, float /*gain*/, float /*pitch*/, float /*pan*/) override {}
+
+    void log_stats() const override {}
+
+private:
+    int effects = 0;
+};
@@ -0,0 +1,107 @@
+#include "frame_pacer.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <mmsystem.h>
+#pragma comment(lib, "winmm.lib")
+#endif
+
+using namespace std;
+
+namespace {
+    const chrono::microseconds min_spin_margin(200);   // Always spin at least this long
+    const chrono::microseconds max_spin_margin(4000);  // Never spin longer than this
+}
+
+FramePacer::FramePacer(int targetHz)
+    : spinMargin(chrono::microseconds(1000)) {
+#ifdef _WIN32
+    timeBeginPeriod(1); // 1 ms scheduler granularity instead of 15.6 ms while we are running
+#endif
+    set_target(targetHz);
+}
+
+FramePacer::~FramePacer() {
+#ifdef _WIN32
+    timeEndPeriod(1);
+#endif
+}
+
+void FramePacer::set_target(int hz) {
+    targetHz = max(hz, 0);
+    period = targetHz > 0 ? clock::duration(chrono::nanoseconds(1000000000LL / targetHz)) : clock::duration::zero();
+    scheduled = false;
+}
+
+void FramePacer::wait() {
+    if (targetHz == 0) {
+        return; // Uncapped: run as fast as possible
+    }
+
+    clock::time_point now = clock::now();
+    if (!scheduled) {
+        deadline = now + period;
+        scheduled = true;
+        return;
+    }
+
+    // Sleep for the bulk of the budget, keeping a margin for the OS to oversleep into
+    clock::time_point sleepUntil = deadline - spinMargin;
+    if (now < sleepUntil) {
+        this_thread::sleep_until(sleepUntil);
+        clock::time_point woke = clock::now();
+
+        // Grow the margin quickly when the OS oversleeps, shrink it slowly otherwise
+        clock::duration overshoot = woke - sleepUntil;
+        if (overshoot * 4 > spinMargin * 3) {
+            spinMargin = overshoot * 3 / 2;
+        }
+        else {
+            spinMargin -= spinMargin / 64;
+        }
+        spinMargin = min<clock::duration>(max<clock::duration>(spinMargin, min_spin_margin), max_spin_margin);
+    }
+
+    // Spin the rest on the high-resolution clock
+    while ((now = clock::now()) < deadline) {
+    }
+
+    // Record how far off the deadline we are
+    double errorMs = chrono::duration<double, milli>(now - deadline).count();
+    ++frames;
+    errorSum += errorMs;
+    errorSquareSum += errorMs * errorMs;
+    errorWorst = max(errorWorst, errorMs);
+    if (now - deadline > period / 10) {
+        ++missed;
+    }
+
+    // Schedule the next frame; after a long stall start over instead of rushing to catch up
+    deadline += period;
+    if (now > deadline) {
+        deadline = now + period;
+    }
+}
+
+PacingStats FramePacer::get_stats() const {
+    PacingStats stats;
+    stats.frames = frames;
+    stats.missedFrames = missed;
+    stats.worstErrorMs = errorWorst;
+    if (frames > 0) {
+        stats.meanErrorMs = errorSum / frames;
+        stats.stddevErrorMs = sqrt(max(0.0, errorSquareSum / frames - stats.meanErrorMs * stats.meanErrorMs));
+    }
+    return stats;
+}
+
+void FramePacer::reset_stats() {
+    frames = 0;
+    missed = 0;
+    errorSum = errorSquareSum = errorWorst = 0.0;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <chrono>
+
+// Error statistics for frames paced so far (positive error = woke up late)
+struct PacingStats {
+    long long frames = 0;
+    double meanErrorMs = 0.0;    // Average signed error against the deadline
+    double stddevErrorMs = 0.0;  // Jitter
+    double worstErrorMs = 0.0;   // Latest wake-up
+    long long missedFrames = 0;  // Frames that started more than a tenth of a period late
+};
+
+// Hybrid sleep/spin frame limiter.
+// wait() sleeps through the bulk of the remaining frame budget, then spins on
+// the high-resolution clock for the last stretch, which is far steadier than
+// sleeping alone (or Window::setFramerateLimit). The spin margin adapts to how
+// much the OS oversleeps, so it stays short on systems with precise timers.
+class FramePacer {
+public:
+    explicit FramePacer(int targetHz = 60); // 0 = uncapped
+    ~FramePacer();
+
+    void set_target(int hz);                // 0 = uncapped; resets the schedule, not the stats
+    int get_target() const { return targetHz; }
+
+    void wait();                            // Blocks until the next frame is due
+
+    PacingStats get_stats() const;
+    void reset_stats();
+
+private:
+    typedef std::chrono::steady_clock clock;
+
+    int targetHz;
+    clock::duration period;
+    clock::time_point deadline;             // When the next frame is due
+    bool scheduled = false;                 // Whether deadline is valid
+    clock::duration spinMargin;             // Tail of the wait that is spun instead of slept
+
+    long long frames = 0;
+    long long missed = 0;
+    double errorSum = 0.0, errorSquareSum = 0.0, errorWorst = 0.0; // In milliseconds
+};
@@ -0,0 +1,10 @@
+#pragma once
+
+// Constants shared by the game, the renderers and the headless tools
+const int screenwidth = 800;             // Screen width
+const int screenheight = 600;            // Screen height
+const float paddlewidth = 20.0f;         // Paddle width
+const float paddleheight = 100.0f;       // Paddle height
+const float ballradius = 10.0f;          // Radius of the ball
+const float initial_ballspeed = 0.5f;    // Initial ball speed
+const int sim_tickrate = 500;            // Simulation ticks per second
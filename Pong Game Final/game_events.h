@@ -0,0 +1,79 @@
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+// Something that happened during a simulation tick. The simulation only records
+// these; sound, particles and statistics react to them later, in batches, on
+// the render thread.
+struct GameEvent {
+    enum Type { PaddleHit, WallBounce, Goal, MatchOver };
+    Type type = PaddleHit;
+    std::uint64_t tick = 0;     // Simulation tick it happened in
+    int ball = -1;              // Ball index, or -1 for MatchOver
+    int side = -1;              // Paddle that hit, player who scored or won (0 = left, 1 = right, -1 = tie)
+    sf::Vector2f position;      // Where it happened, in logical coordinates
+    float speed = 0.0f;         // The ball's speed afterwards in pixels per tick, or 0 without a ball
+};
+
+inline const char* event_name(GameEvent::Type type) {
+    const char* names[] = { "paddle hit", "wall bounce", "goal", "match over" };
+    return names[type];
+}
+
+// The events of one tick, in the order they happened. Storage is a fixed array
+// filled by the simulation thread; a tick that raises more events than fit
+// drops the rest (and counts them) instead of allocating.
+template <std::size_t Capacity>
+class GameEventBuffer {
+public:
+    void clear() { count = 0; }
+
+    void push(const GameEvent& event) {
+        if (count == Capacity) {
+            ++dropped;
+            return;
+        }
+        events[count++] = event;
+    }
+
+    const GameEvent* begin() const { return events; }
+    const GameEvent* end() const { return events + count; }
+    std::size_t size() const { return count; }
+    std::uint64_t get_dropped() const { return dropped; }
+    void reset_dropped() { dropped = 0; }
+
+private:
+    GameEvent events[Capacity];
+    std::size_t count = 0;
+    std::uint64_t dropped = 0;  // Since reset_dropped()
+};
+
+// Per-match totals built from the event stream
+struct MatchStats {
+    int paddleHits = 0;
+    int wallBounces = 0;
+    int goals = 0;
+    int longestRally = 0;       // Most paddle hits between two goals
+    int rally = 0;              // Paddle hits since the last goal
+
+    void record(const GameEvent& event) {
+        switch (event.type) {
+        case GameEvent::PaddleHit:
+            ++paddleHits;
+            longestRally = std::max(longestRally, ++rally);
+            break;
+        case GameEvent::WallBounce:
+            ++wallBounces;
+            break;
+        case GameEvent::Goal:
+            ++goals;
+            rally = 0;
+            break;
+        case GameEvent::MatchOver:
+            break;
+        }
+    }
+};
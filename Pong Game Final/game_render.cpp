@@ -0,0 +1,160 @@
+#include "game_render.h"
+#include "game_constants.h"
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+using namespace std;
+using namespace sf;
+
+namespace {
+    const int ball_segments = 20; // Triangles per batched ball
+
+    // Linear blend that snaps instead of sliding across the screen when a ball is reset
+    Vector2f blend(const Vector2f& from, const Vector2f& to, float alpha) {
+        if (abs(to.x - from.x) > screenwidth / 4.0f || abs(to.y - from.y) > screenheight / 4.0f) {
+            return to;
+        }
+        return from + (to - from) * alpha;
+    }
+
+    // Where ball i is drawn; a ball that did not exist in the previous tick is drawn where it is now
+    Vector2f ball_position(const GameSnapshot& previous, const GameSnapshot& current, size_t i, float alpha) {
+        return i < previous.balls.size() ? blend(previous.balls[i], current.balls[i], alpha) : current.balls[i];
+    }
+}
+
+GameRenderer::GameRenderer(const Font& font, RenderScaler& scaler)
+    : scaler(scaler), paddleShape(Vector2f(paddlewidth, paddleheight)), ballShape(ballradius) {
+    paddleShape.setFillColor(Color::White);
+    ballShape.setFillColor(Color::White);
+
+    const float pi = 3.14159265f;
+    for (int s = 0; s <= ball_segments; ++s) {
+        float angle = 2.0f * pi * s / ball_segments;
+        circleOffsets.push_back(Vector2f(ballradius + ballradius * cos(angle), ballradius + ballradius * sin(angle)));
+    }
+
+    // Score text for left and right player
+    for (Text* text : { &leftScoreText, &rightScoreText }) {
+        text->setFont(font); // Set the font
+        text->setCharacterSize(24); // Set font size
+        text->setFillColor(Color::White); // Set text color
+    }
+    leftScoreText.setPosition(50, 20);
+    rightScoreText.setPosition(screenwidth - 100, 20);
+
+    // Timer text configuration
+    timerText.setFont(font);
+    timerText.setCharacterSize(30);
+    timerText.setFillColor(Color::White);
+    timerText.setPosition(380, 10);      // Position of timer text
+}
+
+void GameRenderer::draw(RenderTarget& target, const GameSnapshot& previous, const GameSnapshot& current, float alpha,
+    const ParticleSystem* particles, const LatchedPaddles* latched) {
+    drawCalls = 0;
+
+    // Clear the playfield target (window or reduced-resolution texture) and redraw game objects
+    RenderTarget& field = scaler.begin(target);
+    Vector2f leftPaddle = blend(previous.leftPaddle, current.leftPaddle, alpha);
+    Vector2f rightPaddle = blend(previous.rightPaddle, current.rightPaddle, alpha);
+    if (latched && latched->left) leftPaddle.y = latched->leftY;
+    if (latched && latched->right) rightPaddle.y = latched->rightY;
+    paddleShape.setPosition(leftPaddle);
+    field.draw(paddleShape);
+    paddleShape.setPosition(rightPaddle);
+    field.draw(paddleShape);
+    drawCalls += 2;
+
+    // Draw balls
+    if (batchBalls) {
+        draw_balls_batched(field, previous, current, alpha);
+    }
+    else {
+        draw_balls_shapes(field, previous, current, alpha);
+    }
+
+    // Draw sparks and goal bursts as one batch
+    if (particles && particles->size() > 0) {
+        particles->draw(field);
+        ++drawCalls;
+    }
+
+    if (scaler.get_scale() < 1.0f) {
+        ++drawCalls; // The upscale blit
+    }
+    scaler.end(target);
+
+    // The HUD stays at native resolution on top of the upscaled playfield
+    draw_overlay(target, current);
+}
+
+void GameRenderer::draw_balls_shapes(RenderTarget& target, const GameSnapshot& previous, const GameSnapshot& current, float alpha) {
+    for (size_t i = 0; i < current.balls.size(); ++i) {
+        ballShape.setPosition(ball_position(previous, current, i, alpha));
+        target.draw(ballShape);
+    }
+    drawCalls += static_cast<unsigned int>(current.balls.size());
+}
+
+void GameRenderer::draw_balls_batched(RenderTarget& target, const GameSnapshot& previous, const GameSnapshot& current, float alpha) {
+    const size_t perBall = ball_segments * 3;
+    const size_t needed = current.balls.size() * perBall;
+    if (needed == 0) {
+        return;
+    }
+    if (ballVertices.size() < needed) {
+        ballVertices.resize(needed, Vertex(Vector2f(), Color::White));
+    }
+
+    // Each ball is a fan of independent triangles so every ball fits in one Triangles batch
+    for (size_t i = 0; i < current.balls.size(); ++i) {
+        Vector2f corner = ball_position(previous, current, i, alpha);
+        Vector2f center = corner + Vector2f(ballradius, ballradius);
+        Vertex* out = &ballVertices[i * perBall];
+        for (int s = 0; s < ball_segments; ++s) {
+            out[0].position = center;
+            out[1].position = corner + circleOffsets[s];
+            out[2].position = corner + circleOffsets[s + 1];
+            out += 3;
+        }
+    }
+
+    target.draw(ballVertices.data(), needed, Triangles);
+    ++drawCalls;
+}
+
+void GameRenderer::set_score_text(Text& text, int& shown, int score) {
+    if (score != shown) {
+        text.setString(std::to_string(score)); // Display the score as text
+        shown = score;
+    }
+}
+
+void GameRenderer::draw_hud(RenderTarget& target, const GameSnapshot& snapshot) {
+    drawCalls = 0;
+    draw_overlay(target, snapshot);
+}
+
+void GameRenderer::draw_overlay(RenderTarget& target, const GameSnapshot& snapshot) {
+    // Draw scores
+    set_score_text(leftScoreText, shownLeftScore, snapshot.leftScore);
+    set_score_text(rightScoreText, shownRightScore, snapshot.rightScore);
+    target.draw(leftScoreText);
+    target.draw(rightScoreText);
+    drawCalls += 2;
+
+    // Draw timer if active
+    if (snapshot.timerMode) {
+        int remainingTime = max(snapshot.remainingTime, 0);
+        if (remainingTime != shownTime) {
+            int minutes = remainingTime / 60;
+            int seconds = remainingTime % 60;
+            timerText.setString(std::to_string(minutes) + ":" + (seconds < 10 ? "0" : "") + std::to_string(seconds));
+            shownTime = remainingTime;
+        }
+        target.draw(timerText);
+        ++drawCalls;
+    }
+}
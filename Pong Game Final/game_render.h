@@ -0,0 +1,57 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include "game_snapshot.h"
+#include "particles.h"
+#include "render_scale.h"
+
+// Paddle positions sampled from the freshest local input just before a frame is
+// drawn ("late latching"); they replace the snapshot's positions for that frame
+struct LatchedPaddles {
+    bool left = false;       // Use leftY instead of the interpolated left paddle
+    bool right = false;      // Use rightY instead of the interpolated right paddle
+    float leftY = 0.0f;
+    float rightY = 0.0f;
+};
+
+// Draws a match from snapshots: the playfield through a RenderScaler, then the HUD
+// at native resolution. It holds all render-side drawables so nothing is rebuilt
+// per frame, and counts its own draw calls for the render benchmark.
+class GameRenderer {
+public:
+    GameRenderer(const sf::Font& font, RenderScaler& scaler);
+
+    // Balls as one triangle batch (default) or as one CircleShape draw per ball
+    void set_batch_balls(bool enabled) { batchBalls = enabled; }
+    bool is_batching_balls() const { return batchBalls; }
+
+    // Draws one frame blended between the two newest snapshots (alpha 0 = previous, 1 = current).
+    // particles and latched may be null when there is nothing to add.
+    void draw(sf::RenderTarget& target, const GameSnapshot& previous, const GameSnapshot& current, float alpha,
+        const ParticleSystem* particles, const LatchedPaddles* latched = nullptr);
+
+    // Just the score and timer overlay
+    void draw_hud(sf::RenderTarget& target, const GameSnapshot& snapshot);
+
+    unsigned int get_draw_calls() const { return drawCalls; } // Issued by the last draw() or draw_hud()
+
+private:
+    void draw_balls_batched(sf::RenderTarget& target, const GameSnapshot& previous, const GameSnapshot& current, float alpha);
+    void draw_balls_shapes(sf::RenderTarget& target, const GameSnapshot& previous, const GameSnapshot& current, float alpha);
+    void draw_overlay(sf::RenderTarget& target, const GameSnapshot& snapshot);
+    void set_score_text(sf::Text& text, int& shown, int score);
+
+    RenderScaler& scaler;
+    bool batchBalls = true;
+    unsigned int drawCalls = 0;
+
+    sf::RectangleShape paddleShape;
+    sf::CircleShape ballShape;
+    std::vector<sf::Vertex> ballVertices;   // Reused batch storage; only ever grows
+    std::vector<sf::Vector2f> circleOffsets; // Unit-circle outline scaled to the ball radius
+
+    // HUD text is only re-laid out when the value changes
+    sf::Text leftScoreText, rightScoreText, timerText;
+    int shownLeftScore = -1, shownRightScore = -1, shownTime = -1;
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Immutable picture of the match after one simulation tick.
+// The simulation thread fills one of these per tick and publishes it through a
+// TripleBuffer; the render thread only ever reads published snapshots.
+struct GameSnapshot {
+    std::uint64_t tick = 0;                          // Simulation tick this snapshot belongs to
+    std::chrono::steady_clock::time_point published; // When the tick finished
+    sf::Vector2f leftPaddle;                         // Top-left corner of the left paddle
+    sf::Vector2f rightPaddle;                        // Top-left corner of the right paddle
+    std::vector<sf::Vector2f> balls;                 // Top-left corner of every ball's bounding box
+    int leftScore = 0;
+    int rightScore = 0;
+    int targetScore = 0;                             // Score needed to win (for score bars)
+    bool timerMode = false;                          // Whether the HUD shows the countdown
+    int remainingTime = 0;                           // Seconds left in Timer Mode
+    bool matchOver = false;                          // Set on the last snapshot of a match
+    std::string winner;                              // Winner text once the match is over
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <SFML/Window/Event.hpp>
+#include <SFML/Window/Keyboard.hpp>
+#include <atomic>
+#include <cstdint>
+
+// A key transition pulled from the window's event queue, handed to the simulation in order
+struct InputEvent {
+    sf::Keyboard::Key key = sf::Keyboard::Unknown;
+    bool pressed = false;
+};
+
+// Keyboard state tracked from the window's event stream.
+// The thread that pumps events calls on_event(); any other thread may query it.
+// Reading is an atomic load instead of a Keyboard::isKeyPressed() call, which on
+// X11 is a synchronous round trip to the server.
+class KeyState {
+public:
+    // Updates the bitsets from KeyPressed / KeyReleased; losing focus releases everything
+    void on_event(const sf::Event& event) {
+        if (event.type == sf::Event::KeyPressed) {
+            set(event.key.code);
+        }
+        else if (event.type == sf::Event::KeyReleased) {
+            reset(event.key.code);
+        }
+        else if (event.type == sf::Event::LostFocus) {
+            clear();
+        }
+    }
+
+    // Whether the key is held right now
+    bool is_down(sf::Keyboard::Key key) const {
+        if (!valid(key)) return false;
+        return (down[word(key)].load(std::memory_order_relaxed) & bit(key)) != 0;
+    }
+
+    // Releases every key (e.g. when the window loses focus)
+    void clear() {
+        for (int i = 0; i < words; ++i) {
+            down[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    static const int words = (sf::Keyboard::KeyCount + 63) / 64;
+
+    static bool valid(sf::Keyboard::Key key) { return key >= 0 && key < sf::Keyboard::KeyCount; }
+    static int word(sf::Keyboard::Key key) { return key / 64; }
+    static std::uint64_t bit(sf::Keyboard::Key key) { return std::uint64_t(1) << (key % 64); }
+
+    void set(sf::Keyboard::Key key) {
+        if (!valid(key)) return;
+        down[word(key)].fetch_or(bit(key), std::memory_order_relaxed);
+    }
+
+    void reset(sf::Keyboard::Key key) {
+        if (!valid(key)) return;
+        down[word(key)].fetch_and(~bit(key), std::memory_order_relaxed);
+    }
+
+    std::atomic<std::uint64_t> down[words] = {}; // Keys currently held
+};
@@ -0,0 +1,188 @@
+#include "logger.h"
+#include "spsc_queue.h"
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+using namespace std;
+
+namespace {
+    typedef chrono::steady_clock log_clock;
+
+    const size_t ring_records = 1024; // Per thread
+
+    struct LogRecord {
+        LogLevel level;
+        log_clock::time_point time;
+        char text[120];                // Longer messages are truncated
+    };
+
+    // One producer thread at a time; the drain thread is the only consumer
+    struct LogRing {
+        SpscQueue<LogRecord, ring_records> records;
+        atomic<bool> owned{ false };   // Held by a live thread; released when it exits, so another can reuse the ring
+        atomic<uint64_t> dropped{ 0 }; // Records lost to a full ring
+    };
+
+    // Rings are claimed from a static pool, so neither logging nor thread start-up allocates.
+    // Untouched rings cost no physical memory.
+    const size_t max_rings = 32;
+    LogRing ring_pool[max_rings];
+    atomic<size_t> ring_count{ 0 };    // Rings ever claimed; the drain thread scans [0, ring_count)
+
+    atomic<bool> running{ false };
+    atomic<int> min_level{ static_cast<int>(LogLevel::Info) }; // Runtime filter; --log-level debug lowers it
+    thread drain_thread;
+    FILE* output = stderr;
+    const log_clock::time_point start_time = log_clock::now();
+
+    const char* level_name(LogLevel level) {
+        switch (level) {
+        case LogLevel::Debug: return "DEBUG";
+        case LogLevel::Info: return "INFO ";
+        case LogLevel::Warning: return "WARN ";
+        default: return "ERROR";
+        }
+    }
+
+    void print_record(const LogRecord& record) {
+        double seconds = chrono::duration<double>(record.time - start_time).count();
+        fprintf(output, "[%10.4f] %s %s\n", seconds, level_name(record.level), record.text);
+    }
+
+    // Claims a free ring or registers a new one; released again when the thread exits
+    struct RingOwner {
+        LogRing* ring = nullptr;
+
+        LogRing* get() {
+            if (ring) {
+                return ring;
+            }
+            for (size_t i = 0; i < max_rings; ++i) {
+                bool expected = false;
+                if (ring_pool[i].owned.compare_exchange_strong(expected, true, memory_order_acquire)) {
+                    ring = &ring_pool[i];
+                    size_t count = ring_count.load(memory_order_relaxed);
+                    while (count < i + 1 && !ring_count.compare_exchange_weak(count, i + 1, memory_order_release)) {
+                    }
+                    return ring;
+                }
+            }
+            return nullptr; // More logging threads than rings; this one logs nothing
+        }
+
+        ~RingOwner() {
+            if (ring) {
+                ring->owned.store(false, memory_order_release);
+            }
+        }
+    };
+
+    thread_local RingOwner ring_owner;
+
+    // Writes out everything queued so far; returns the number of records written
+    size_t drain_rings() {
+        size_t written = 0;
+        LogRecord record;
+        const size_t count = ring_count.load(memory_order_acquire);
+        for (size_t i = 0; i < count; ++i) {
+            LogRing& ring = ring_pool[i];
+            while (ring.records.pop(record)) {
+                print_record(record);
+                ++written;
+            }
+            uint64_t dropped = ring.dropped.exchange(0, memory_order_relaxed);
+            if (dropped > 0) {
+                fprintf(output, "[%10.4f] WARN  %llu log records dropped (ring full)\n",
+                    chrono::duration<double>(log_clock::now() - start_time).count(), static_cast<unsigned long long>(dropped));
+            }
+        }
+        if (written > 0) {
+            fflush(output); // Once per batch, not per line
+        }
+        return written;
+    }
+
+    void drain_loop() {
+        while (running.load(memory_order_acquire)) {
+            if (drain_rings() == 0) {
+                this_thread::sleep_for(chrono::milliseconds(5));
+            }
+        }
+        drain_rings(); // Whatever was logged before log_stop()
+    }
+}
+
+bool log_start(const char* path) {
+    if (running) {
+        return true;
+    }
+    bool opened = true;
+    if (path) {
+        FILE* file = fopen(path, "a");
+        if (file) {
+            output = file;
+        }
+        else {
+            opened = false; // Keep logging to stderr
+        }
+    }
+    running = true;
+    drain_thread = thread(drain_loop);
+    return opened;
+}
+
+void log_stop() {
+    if (!running) {
+        return;
+    }
+    running = false;
+    drain_thread.join();
+    if (output != stderr) {
+        fclose(output);
+        output = stderr;
+    }
+}
+
+void log_set_level(LogLevel level) {
+    min_level.store(static_cast<int>(level), memory_order_relaxed);
+}
+
+bool log_parse_level(const char* name, LogLevel& level) {
+    const char* names[] = { "debug", "info", "warning", "error" };
+    for (int i = 0; i < 4; ++i) {
+        if (strcmp(name, names[i]) == 0) {
+            level = static_cast<LogLevel>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+void log_write(LogLevel level, const char* format, ...) {
+    if (static_cast<int>(level) < min_level.load(memory_order_relaxed)) {
+        return;
+    }
+
+    LogRecord record;
+    record.level = level;
+    record.time = log_clock::now();
+    va_list args;
+    va_start(args, format);
+    vsnprintf(record.text, sizeof(record.text), format, args);
+    va_end(args);
+
+    // Without a drain thread (before log_start or after log_stop) write directly
+    if (!running.load(memory_order_acquire)) {
+        print_record(record);
+        return;
+    }
+
+    LogRing* ring = ring_owner.get();
+    if (ring && !ring->records.push(record)) {
+        ring->dropped.fetch_add(1, memory_order_relaxed);
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+// Asynchronous logger.
+// log_write() formats a record into a lock-free ring owned by the calling thread
+// and returns; a background thread drains every ring to stderr or a file and
+// flushes once per batch, so logging never blocks on I/O. A full ring drops the
+// record (dropped records are reported) rather than waiting.
+//
+// Use the LOG_* macros. Levels below PONG_LOG_MIN_LEVEL are compiled out
+// entirely, arguments included; by default that removes LOG_DEBUG from release
+// (NDEBUG) builds. Define PONG_LOG_MIN_LEVEL to 0 to keep it.
+
+enum class LogLevel { Debug, Info, Warning, Error };
+
+bool log_start(const char* path = nullptr); // Starts the drain thread; logs to path (appending), or stderr if null
+void log_stop();                            // Writes everything still queued and stops the drain thread
+void log_set_level(LogLevel level);         // Runtime filter on top of the compile-time one
+void log_write(LogLevel level, const char* format, ...); // printf-style; use the macros below instead
+bool log_parse_level(const char* name, LogLevel& level); // "debug", "info", "warning" or "error"
+
+#ifndef PONG_LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define PONG_LOG_MIN_LEVEL 1
+#else
+#define PONG_LOG_MIN_LEVEL 0
+#endif
+#endif
+
+#if PONG_LOG_MIN_LEVEL <= 0
+#define LOG_DEBUG(...) log_write(LogLevel::Debug, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) ((void)0)
+#endif
+
+#if PONG_LOG_MIN_LEVEL <= 1
+#define LOG_INFO(...) log_write(LogLevel::Info, __VA_ARGS__)
+#else
+#define LOG_INFO(...) ((void)0)
+#endif
+
+#if PONG_LOG_MIN_LEVEL <= 2
+#define LOG_WARNING(...) log_write(LogLevel::Warning, __VA_ARGS__)
+#else
+#define LOG_WARNING(...) ((void)0)
+#endif
+
+#define LOG_ERROR(...) log_write(LogLevel::Error, __VA_ARGS__)
@@ -0,0 +1,260 @@
+#include "lookahead_planner.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace {
+    const float face_offsets[] = { -35.0f, 0.0f, 35.0f }; // Where on the paddle face to meet the ball
+    const int start_delays[] = { 0, 20, 60 };             // Ticks to wait before moving
+    const size_t planned_balls = 3;      // Intercepts of this many soonest balls become candidates
+    const size_t max_rounds = 32;        // Opponent draws per candidate; more rarely changes the pick
+    const double return_bonus = 0.1;     // Sending the ball back is worth something even without a goal
+    const double travel_cost = 0.01;     // Per screen height travelled; breaks ties towards moving less
+
+    // Centre y where the soonest ball reaches planeX; false if none is heading there
+    bool soonest_intercept(const MatchState& match, float planeX, float& y) {
+        float best = 0.0f;
+        bool found = false;
+        for (const BallState& ball : match.balls) {
+            float ballY, ticks;
+            if (predict_intercept(ball, planeX, ballY, ticks) && (!found || ticks < best)) {
+                best = ticks;
+                y = ballY + ballradius;
+                found = true;
+            }
+        }
+        return found;
+    }
+
+    // Offset that moves a paddle towards centre y, with a dead zone against jitter
+    float follow(float paddleY, float y, float speed) {
+        float center = paddleY + paddleheight / 2.0f;
+        if (center < y - speed) {
+            return speed;
+        }
+        return center > y + speed ? -speed : 0.0f;
+    }
+}
+
+LookaheadPlanner::LookaheadPlanner(unsigned int threads) {
+    if (threads == 0) {
+        unsigned int hardware = thread::hardware_concurrency();
+        threads = hardware > 3 ? hardware - 2 : 1; // Leave the render and simulation threads their cores
+    }
+    workers.resize(threads);
+}
+
+LookaheadPlanner::~LookaheadPlanner() {
+    {
+        lock_guard<mutex> lock(jobMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (Worker& worker : workers) {
+        if (worker.thread.joinable()) {
+            worker.thread.join();
+        }
+    }
+}
+
+void LookaheadPlanner::start_threads() {
+    for (size_t i = 0; i < workers.size(); ++i) {
+        workers[i].thread = thread(&LookaheadPlanner::worker_thread, this, i);
+    }
+    started = true;
+}
+
+bool LookaheadPlanner::start(const MatchState& state, const LookaheadSettings& planSettings) {
+    if (is_busy()) {
+        return false;
+    }
+    if (!started) {
+        start_threads();
+    }
+
+    // No worker touches the job while none is running; the generation bump under the
+    // lock then makes it visible to them
+    build_candidates(state);
+    const size_t count = candidates.size();
+    for (Worker& worker : workers) {
+        worker.totals.assign(count, 0.0);
+        worker.counts.assign(count, 0);
+    }
+    root = state; // Reuses the copy's ball storage
+    settings = planSettings;
+    nextRollout.store(0, memory_order_relaxed);
+    deadline = chrono::steady_clock::now() + settings.budget;
+    {
+        lock_guard<mutex> lock(jobMutex);
+        ++generation;
+        busy = workers.size();
+        running = true;
+    }
+    wake.notify_all();
+    return true;
+}
+
+bool LookaheadPlanner::poll(PaddlePlan& result) {
+    {
+        lock_guard<mutex> lock(jobMutex);
+        if (!running || busy > 0) {
+            return false;
+        }
+        running = false;
+    }
+    result = best_plan();
+    return true;
+}
+
+bool LookaheadPlanner::is_busy() {
+    lock_guard<mutex> lock(jobMutex);
+    return running;
+}
+
+PaddlePlan LookaheadPlanner::plan(const MatchState& state, const LookaheadSettings& planSettings) {
+    {
+        // Collect (and drop) a plan still running from an earlier start()
+        unique_lock<mutex> lock(jobMutex);
+        finished.wait(lock, [this] { return busy == 0; });
+        running = false;
+    }
+    start(state, planSettings);
+    {
+        unique_lock<mutex> lock(jobMutex);
+        finished.wait(lock, [this] { return busy == 0; });
+        running = false;
+    }
+    return best_plan();
+}
+
+PaddlePlan LookaheadPlanner::best_plan() {
+    // Best mean outcome; ties go to the earlier candidate (no delay, listed first)
+    const size_t count = candidates.size();
+    size_t best = 0;
+    double bestMean = 0.0;
+    for (size_t c = 0; c < count; ++c) {
+        double total = 0.0;
+        uint32_t played = 0;
+        for (const Worker& worker : workers) {
+            total += worker.totals[c];
+            played += worker.counts[c];
+        }
+        rollouts += played;
+        if (played > 0 && (c == 0 || total / played > bestMean)) {
+            best = c;
+            bestMean = total / played;
+        }
+    }
+    return candidates[best];
+}
+
+void LookaheadPlanner::worker_thread(size_t index) {
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            unique_lock<mutex> lock(jobMutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+        }
+        run_rollouts(workers[index]);
+        {
+            lock_guard<mutex> lock(jobMutex);
+            if (--busy == 0) {
+                finished.notify_all();
+            }
+        }
+    }
+}
+
+void LookaheadPlanner::run_rollouts(Worker& worker) {
+    // The first round always completes so every candidate has an outcome; later rounds stop at the deadline
+    const size_t count = candidates.size();
+    for (;;) {
+        size_t index = nextRollout.fetch_add(1, memory_order_relaxed);
+        if (index >= count * max_rounds || (index >= count && chrono::steady_clock::now() >= deadline)) {
+            return;
+        }
+        size_t candidate = index % count;
+        uint32_t seed = static_cast<uint32_t>(index / count + 1) * 0x9E3779B9u; // Same opponent for the whole round
+        worker.totals[candidate] += rollout(worker, candidates[candidate], seed);
+        ++worker.counts[candidate];
+    }
+}
+
+double LookaheadPlanner::rollout(Worker& worker, const PaddlePlan& plan, uint32_t seed) {
+    MatchState& match = worker.scratch;
+    match = root; // Reuses the scratch copy's ball storage
+
+    const float leftPlane = left_paddle_x + paddlewidth;
+    const float rightPlane = right_paddle_x - 2 * ballradius;
+    const float aimError = settings.opponentError * xorshift_signed(seed);
+    double value = -travel_cost * abs(plan.targetY - (root.rightPaddleY + paddleheight / 2.0f)) / screenheight;
+
+    // The plan covers the next return; after that the paddle simply meets the soonest ball
+    bool planDone = false;
+    for (int tick = 0; tick < settings.horizon; ++tick) {
+        float leftY, rightY = plan.targetY;
+        float leftOffset = soonest_intercept(match, leftPlane, leftY)
+            ? follow(match.leftPaddleY, leftY + aimError, settings.opponentSpeed) : 0.0f;
+        if (planDone && !soonest_intercept(match, rightPlane, rightY)) {
+            rightY = screenheight / 2.0f;
+        }
+        float rightOffset = planDone || tick >= plan.delay ? follow(match.rightPaddleY, rightY, settings.speed) : 0.0f;
+
+        // Sooner wins and later losses are better: a late loss leaves time for the next plan
+        int events = step_match(match, leftOffset, rightOffset);
+        double progress = static_cast<double>(tick) / settings.horizon;
+        if (events & LeftScored) {
+            return value - 1.0 + 0.5 * progress;
+        }
+        if (events & RightScored) {
+            return value + 1.0 - 0.5 * progress;
+        }
+        if ((events & RightPaddleHit) && !planDone) {
+            planDone = true;
+            value += return_bonus;
+        }
+    }
+    return value;
+}
+
+void LookaheadPlanner::build_candidates(const MatchState& state) {
+    // The soonest few balls heading for the right paddle
+    struct Incoming {
+        float ticks, y;
+        bool operator<(const Incoming& other) const { return ticks < other.ticks; }
+    };
+    vector<Incoming> incoming;
+    for (const BallState& ball : state.balls) {
+        Incoming arrival;
+        if (predict_intercept(ball, right_paddle_x - 2 * ballradius, arrival.y, arrival.ticks)) {
+            arrival.y += ballradius;
+            incoming.push_back(arrival);
+        }
+    }
+    size_t planned = min(incoming.size(), planned_balls);
+    partial_sort(incoming.begin(), incoming.begin() + planned, incoming.end());
+
+    vector<float> targets;
+    for (size_t i = 0; i < planned; ++i) {
+        for (float offset : face_offsets) {
+            targets.push_back(incoming[i].y + offset);
+        }
+    }
+    targets.push_back(screenheight / 2.0f);
+    targets.push_back(state.rightPaddleY + paddleheight / 2.0f); // Stay put
+
+    candidates.clear();
+    for (float y : targets) {
+        for (int delay : start_delays) {
+            PaddlePlan plan;
+            plan.targetY = min(max(y, paddleheight / 2.0f), screenheight - paddleheight / 2.0f);
+            plan.delay = delay;
+            candidates.push_back(plan);
+        }
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "game_constants.h"
+#include "match_state.h"
+
+// One thing the right paddle could do: hold still for a while, then head for a centre y
+struct PaddlePlan {
+    float targetY = screenheight / 2.0f; // Paddle centre to head for
+    int delay = 0;                        // Ticks to wait before moving
+};
+
+struct LookaheadSettings {
+    float speed = 8.0f;                  // Right paddle movement per tick
+    float opponentSpeed = 2.5f;          // Left paddle movement per tick in the rollouts
+    float opponentError = 40.0f;         // The modelled opponent misjudges by up to this many pixels
+    int horizon = 1500;                  // Ticks played ahead per rollout
+    std::chrono::microseconds budget = std::chrono::microseconds(2000); // Per plan() call
+};
+
+// Expert AI for the right paddle. plan() builds a handful of candidate plans (the
+// intercepts of the soonest incoming balls, offset along the paddle face, plus the
+// centre and staying put, each with a few start delays) and plays each forward on
+// copies of the match with step_match(), against an opponent that aims with a random
+// error drawn per rollout. Rollouts are spread over worker threads and continue,
+// round after round, until the time budget is spent; the plan with the best mean
+// outcome wins. Every candidate in a round meets the same opponent draw, so the
+// comparison is not swamped by the opponent's luck.
+// The rollouts run on the planner's own threads: start() returns at once, so the
+// simulation thread keeps its tick rate while a plan is worked out, and picks the
+// plan up with poll() a tick or two later.
+class LookaheadPlanner {
+public:
+    explicit LookaheadPlanner(unsigned int threads = 0); // 0: the hardware threads the game's own two leave free
+    ~LookaheadPlanner();
+
+    // Hands a copy of state to the workers and returns. One plan at a time: false,
+    // and nothing started, while the previous one has not been collected by poll().
+    bool start(const MatchState& state, const LookaheadSettings& settings);
+
+    // True (once) when the started plan is done, with the plan in result
+    bool poll(PaddlePlan& result);
+    bool is_busy();   // A plan was started and has not been collected yet
+
+    // start(), then waits for the plan; for tools that have nothing else to do meanwhile
+    PaddlePlan plan(const MatchState& state, const LookaheadSettings& settings);
+
+    std::uint64_t get_rollouts() const { return rollouts; } // Across every collected plan so far
+    std::size_t get_thread_count() const { return workers.size(); }
+
+private:
+    struct Worker {
+        std::thread thread;
+        MatchState scratch;          // The copy each rollout plays on
+        std::vector<double> totals;  // Per candidate: summed outcome and rollouts
+        std::vector<std::uint32_t> counts;
+    };
+
+    void start_threads();
+    void worker_thread(std::size_t index);
+    void run_rollouts(Worker& worker);
+    double rollout(Worker& worker, const PaddlePlan& plan, std::uint32_t seed);
+    void build_candidates(const MatchState& state);
+    PaddlePlan best_plan();                 // Once every worker is done with the job
+
+    std::vector<Worker> workers;
+    bool started = false;                   // Worker threads are started by the first start()
+
+    // The current job; written by start() before the generation changes, and only
+    // while no job is running
+    MatchState root;
+    LookaheadSettings settings;
+    std::vector<PaddlePlan> candidates;
+    std::chrono::steady_clock::time_point deadline;
+    std::atomic<std::size_t> nextRollout{ 0 }; // Rollout r plays candidate r % candidates in round r / candidates
+
+    std::mutex jobMutex;
+    std::condition_variable wake;           // A new job, or stopping
+    std::condition_variable finished;       // The last busy worker is done
+    std::uint64_t generation = 0;
+    std::size_t busy = 0;                   // Workers still on the current job
+    bool running = false;                   // A job was started and not yet collected
+    bool stopping = false;
+
+    std::uint64_t rollouts = 0;
+};
@@ -0,0 +1,84 @@
+#include "match_state.h"
+#include <cmath>
+
+using namespace std;
+
+float ball_speed_for(int difficulty) {
+    switch (difficulty) {
+    case 0: return 0.8f;         // Easy difficulty
+    case 2: case 3: return 1.6f; // Hard and Expert difficulty
+    default: return 1.2f;        // Medium or default difficulty
+    }
+}
+
+float player_paddle_speed_for(int difficulty) {
+    const float base = 1.0f;
+    switch (difficulty) {
+    case 0: return base;                 // Slower paddle for easier gameplay
+    case 2: case 3: return base + 1.5f;  // Faster paddle for harder gameplay
+    default: return base + 0.8f;         // Medium or default difficulty
+    }
+}
+
+void normalize_ball_speed(BallState& ball, float speed) {
+    float length = sqrt(ball.vx * ball.vx + ball.vy * ball.vy);
+    ball.vx = ball.vx / length * speed;
+    ball.vy = ball.vy / length * speed;
+}
+
+bool ball_hits_wall(const BallState& ball) {
+    return ball.y <= 0 || ball.y + 2 * ballradius >= screenheight;
+}
+
+bool ball_overlaps_paddle(const BallState& ball, float paddleX, float paddleY) {
+    // The overlap must have some area; touching edges do not count
+    return ball.x < paddleX + paddlewidth && paddleX < ball.x + 2 * ballradius
+        && ball.y < paddleY + paddleheight && paddleY < ball.y + 2 * ballradius;
+}
+
+void move_paddle(float& paddleY, float offset) {
+    if ((offset < 0 && paddleY > 0) || (offset > 0 && paddleY < screenheight - paddleheight)) {
+        paddleY += offset;
+    }
+}
+
+int step_match(MatchState& state, float leftOffset, float rightOffset) {
+    move_paddle(state.leftPaddleY, leftOffset);
+    move_paddle(state.rightPaddleY, rightOffset);
+
+    for (BallState& ball : state.balls) {
+        normalize_ball_speed(ball, state.ballSpeed);
+        ball.x += ball.vx;
+        ball.y += ball.vy;
+    }
+
+    int events = 0;
+    for (BallState& ball : state.balls) {
+        if (ball_hits_wall(ball)) {
+            ball.vy = -ball.vy;
+        }
+
+        if (ball_overlaps_paddle(ball, left_paddle_x, state.leftPaddleY)) {
+            events |= ball.vx < 0 ? LeftPaddleHit : 0;
+            ball.vx = abs(ball.vx);
+        }
+        else if (ball_overlaps_paddle(ball, right_paddle_x, state.rightPaddleY)) {
+            events |= ball.vx > 0 ? RightPaddleHit : 0;
+            ball.vx = -abs(ball.vx);
+        }
+
+        if (ball.x <= 0 || ball.x + 2 * ballradius >= screenwidth) {
+            if (ball.x <= 0) {
+                ++state.rightScore;
+                events |= RightScored;
+            }
+            else {
+                ++state.leftScore;
+                events |= LeftScored;
+            }
+            ball.x = screenwidth / 2.0f - ballradius; // Like reset_ball(): back to the centre, same velocity
+            ball.y = screenheight / 2.0f - ballradius;
+        }
+    }
+    return events;
+}
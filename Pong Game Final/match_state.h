@@ -0,0 +1,39 @@
+#pragma once
+
+#include <vector>
+#include "game_constants.h"
+#include "paddle_ai.h"
+
+const float left_paddle_x = 50.0f;                                   // Left paddle's left edge
+const float right_paddle_x = screenwidth - 50.0f - paddlewidth;      // Right paddle's left edge
+
+// The rules of a tick, shared by the game's check_collisions() and adjust_ballspeed()
+// and by step_match(), so anything that plays ahead plays by the same rules
+float ball_speed_for(int difficulty);                                // Pixels per tick every ball is held at
+float player_paddle_speed_for(int difficulty);                       // Pixels per tick a player's paddle moves
+void normalize_ball_speed(BallState& ball, float speed);             // Keeps the direction, sets the length
+bool ball_hits_wall(const BallState& ball);                          // Touching the top or bottom edge
+bool ball_overlaps_paddle(const BallState& ball, float paddleX, float paddleY); // Same test as sf::FloatRect::intersects
+void move_paddle(float& paddleY, float offset);                      // Moves unless already at the edge it heads for
+
+// A match as plain data: copying one is a few assignments (the ball vector keeps
+// its capacity), so the AI can clone it and play candidate moves ahead.
+struct MatchState {
+    float leftPaddleY = 0.0f, rightPaddleY = 0.0f; // Top edges
+    std::vector<BallState> balls;
+    int leftScore = 0, rightScore = 0;
+    float ballSpeed = 1.2f;                        // From ball_speed_for()
+};
+
+// What happened during one step_match(), as bit flags
+enum MatchStepEvents {
+    LeftPaddleHit = 1,  // A ball turned around on the left paddle
+    RightPaddleHit = 2,
+    LeftScored = 4,     // A ball went out on the right
+    RightScored = 8,
+};
+
+// One simulation tick in simulate_tick()'s order: paddles move by the given offsets,
+// balls are held at ballSpeed and move, then bounce off walls and paddles, and balls
+// that went out score and restart from the centre. Returns MatchStepEvents flags.
+int step_match(MatchState& state, float leftOffset, float rightOffset);
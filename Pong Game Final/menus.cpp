@@ -0,0 +1,307 @@
+#include "menus.h"
+#include "game_constants.h"
+
+using namespace sf;
+
+void build_mode_selection_screen(ModeSelectionScreen& screen, const Font& gameFont) {
+    // Title Text
+    screen.titleText.setFont(gameFont);
+    screen.titleText.setString("Select Mode");
+    screen.titleText.setCharacterSize(50);
+    screen.titleText.setFillColor(Color::White);
+    screen.titleText.setStyle(Text::Bold);
+    screen.titleText.setOutlineColor(Color::Black);
+    screen.titleText.setOutlineThickness(2);
+    screen.titleText.setPosition((screenwidth - screen.titleText.getLocalBounds().width) / 2, 30);
+
+    // Score Limit Options Title
+    screen.scoreLimitTitle.setFont(gameFont);
+    screen.scoreLimitTitle.setString("Set Score Limit or Timer Mode:");
+    screen.scoreLimitTitle.setCharacterSize(30);
+    screen.scoreLimitTitle.setFillColor(Color::White);
+    screen.scoreLimitTitle.setOutlineColor(Color::Black);
+    screen.scoreLimitTitle.setOutlineThickness(1);
+    screen.scoreLimitTitle.setPosition((screenwidth - screen.scoreLimitTitle.getLocalBounds().width) / 2, 280);
+
+    // One row per button, in ModeSelectionScreen::ButtonId order
+    const float center = screenwidth / 2.0f;
+    const ButtonSpec buttons[] = {
+        // label,          area,                                  size, normal,             hover,              click,              text,         outline, label offset
+        { "Single Player", FloatRect(center - 125, 100, 250, 60), 30,   Color(50, 70, 120), Color(30, 50, 100), Color(20, 40, 80),  Color::White, 2,       Vector2f(30, 10) },
+        { "Multiplayer",   FloatRect(center - 125, 180, 250, 60), 30,   Color(150, 30, 80), Color(120, 20, 60), Color(100, 10, 40), Color::White, 2,       Vector2f(40, 10) },
+        { "15",            FloatRect(center - 130, 330, 80, 50),  20,   Color(30, 70, 30),  Color(20, 50, 20),  Color(10, 40, 10),  Color::White, 2,       Vector2f(25, 10) },
+        { "25",            FloatRect(center - 40, 330, 80, 50),   20,   Color(120, 120, 0), Color(100, 100, 0), Color(80, 80, 0),   Color::White, 2,       Vector2f(25, 10) },
+        { "40",            FloatRect(center + 50, 330, 80, 50),   20,   Color(120, 20, 0),  Color(100, 10, 0),  Color(80, 0, 0),    Color::White, 2,       Vector2f(25, 10) },
+        { "Timer Mode",    FloatRect(center - 125, 410, 250, 60), 30,   Color(0, 100, 100), Color(0, 80, 80),   Color(0, 60, 60),   Color::White, 2,       Vector2f(40, 10) },
+    };
+    screen.buttons.build(gameFont, buttons, sizeof(buttons) / sizeof(buttons[0]));
+}
+
+void draw_mode_selection_screen(RenderTarget& target, const ModeSelectionScreen& screen) {
+    target.draw(screen.titleText);
+    target.draw(screen.scoreLimitTitle);
+    screen.buttons.draw(target);
+}
+
+WelcomeScene::WelcomeScene(const Font& gameFont, Scene& playScene, Scene& creditsScene)
+    : playScene(playScene), creditsScene(creditsScene) {
+    // Title text setup
+    titleText.setFont(gameFont);
+    titleText.setString("Pong Game");
+    titleText.setCharacterSize(70);
+    titleText.setFillColor(Color::White);
+    FloatRect titleBounds = titleText.getLocalBounds();
+    titleText.setPosition((screenwidth - titleBounds.width) / 2, 100);
+
+    // Buttons for Play, Exit, and Credits; hovering highlights them
+    const float left = screenwidth / 2.0f - 100, middle = screenheight / 2.0f;
+    const ButtonSpec buttons[] = {
+        // label,    area,                                size, normal,       hover,          click,          text,         outline, label offset
+        { "Play",    FloatRect(left, middle - 70, 200, 50), 30, Color::Green, Color::Yellow,  Color::Yellow,  Color::White, 0,       Vector2f(70, 5) },
+        { "Exit",    FloatRect(left, middle + 20, 200, 50), 30, Color::Red,   Color::Magenta, Color::Magenta, Color::White, 0,       Vector2f(70, 5) },
+        { "Credits", FloatRect(left, middle + 110, 200, 50), 30, Color::Blue, Color::Cyan,    Color::Cyan,    Color::White, 0,       Vector2f(45, 5) },
+    };
+    this->buttons.build(gameFont, buttons, sizeof(buttons) / sizeof(buttons[0]));
+}
+
+void WelcomeScene::enter(const Vector2f& mousePosition) {
+    buttons.reset_pointer(mousePosition);
+}
+
+bool WelcomeScene::handle_event(const Event& event, SceneStack& stack) {
+    bool changed = buttons.track_pointer(event);
+    switch (buttons.clicked(event)) {
+    case Play:
+        stack.push(playScene);
+        break;
+    case Exit:
+        stack.quit();
+        break;
+    case Credits:
+        stack.push(creditsScene);
+        break;
+    }
+    return changed;
+}
+
+void WelcomeScene::draw(RenderTarget& target) const {
+    target.draw(titleText);
+    buttons.draw(target);
+}
+
+ModeSelectionScene::ModeSelectionScene(const Font& gameFont, MatchSettings& settings, Scene& difficultyScene)
+    : settings(settings), difficultyScene(difficultyScene) {
+    build_mode_selection_screen(screen, gameFont);
+}
+
+void ModeSelectionScene::enter(const Vector2f& mousePosition) {
+    screen.buttons.reset_pointer(mousePosition);
+}
+
+bool ModeSelectionScene::handle_event(const Event& event, SceneStack& stack) {
+    bool changed = screen.buttons.track_pointer(event);
+    switch (screen.buttons.clicked(event)) {
+    case ModeSelectionScreen::SinglePlayer:
+        settings.singlePlayer = true;
+        stack.push(difficultyScene);
+        break;
+    case ModeSelectionScreen::Multiplayer:
+        settings.singlePlayer = false;
+        stack.push(difficultyScene);
+        break;
+    case ModeSelectionScreen::Score15:
+        settings.timerMode = false;
+        settings.targetScore = 15;
+        break;
+    case ModeSelectionScreen::Score25:
+        settings.timerMode = false;
+        settings.targetScore = 25;
+        break;
+    case ModeSelectionScreen::Score40:
+        settings.timerMode = false;
+        settings.targetScore = 40;
+        break;
+    case ModeSelectionScreen::TimerMode:
+        settings.timerMode = true;
+        settings.targetScore = 1000;
+        break;
+    }
+    return changed;
+}
+
+void ModeSelectionScene::draw(RenderTarget& target) const {
+    draw_mode_selection_screen(target, screen);
+}
+
+DifficultyScene::DifficultyScene(const Font& gameFont, MatchSettings& settings)
+    : settings(settings) {
+    // Title Text
+    titleText.setFont(gameFont);
+    titleText.setString("Select Difficulty"); // Set the title text
+    titleText.setCharacterSize(50); // Set the font size
+    titleText.setFillColor(Color::White); // Set the text color to white
+    titleText.setPosition((screenwidth - titleText.getLocalBounds().width) / 2, 100); // Center the title at the top
+
+    // Easy, Medium, Hard and Expert buttons; the row index is the difficulty level
+    const float left = screenwidth / 2.0f - 100, middle = screenheight / 2.0f;
+    const Color purple(128, 0, 128);
+    const ButtonSpec buttons[] = {
+        // label,   area,                                 size, normal,        hover,         click,         text,         outline, label offset
+        { "Easy",   FloatRect(left, middle - 110, 200, 50), 30, Color::Green,  Color::Green,  Color::Green,  Color::White, 0,       Vector2f(60, 5) },
+        { "Medium", FloatRect(left, middle - 30, 200, 50),  30, Color::Yellow, Color::Yellow, Color::Yellow, Color::Black, 0,       Vector2f(45, 5) },
+        { "Hard",   FloatRect(left, middle + 50, 200, 50),  30, Color::Red,    Color::Red,    Color::Red,    Color::White, 0,       Vector2f(55, 5) },
+        { "Expert", FloatRect(left, middle + 130, 200, 50), 30, purple,        purple,        purple,        Color::White, 0,       Vector2f(45, 5) },
+    };
+    this->buttons.build(gameFont, buttons, sizeof(buttons) / sizeof(buttons[0]));
+}
+
+bool DifficultyScene::handle_event(const Event& event, SceneStack& stack) {
+    // Picking a difficulty ends the menus and starts the match
+    int picked = buttons.clicked(event);
+    if (picked >= 0) {
+        settings.difficulty = picked; // 0 = Easy, 1 = Medium, 2 = Hard, 3 = Expert
+        stack.finish();
+    }
+    return false;
+}
+
+void DifficultyScene::draw(RenderTarget& target) const {
+    target.draw(titleText); // Draw the title text
+    buttons.draw(target); // Draw the buttons and their labels
+}
+
+CreditsScene::CreditsScene(const Font& gameFont) {
+    // Setup for the "Back" button, with its label centered
+    const ButtonSpec back = {
+        "Back", FloatRect(screenwidth / 2.0f - 100, screenheight - 100.0f, 200, 50), 30,
+        Color(34, 139, 34), Color(34, 139, 34), Color(34, 139, 34), Color::White, 0, Vector2f(center_label, 7) // Dark Green color
+    };
+    backButton.build(gameFont, &back, 1);
+
+    // Title text for the Credits screen
+    creditsTitle.setFont(gameFont);
+    creditsTitle.setString("Credits");
+    creditsTitle.setCharacterSize(50);
+    creditsTitle.setFillColor(Color(135, 206, 250)); // Sky Blue color
+    creditsTitle.setPosition(
+        (screenwidth - creditsTitle.getLocalBounds().width) / 2,
+        50
+    );
+
+    // List of credits
+    creditsInfo.setFont(gameFont);
+    creditsInfo.setString(
+        "Developed by:\n\n"
+        "1. Ahmed Ashraf\n"
+        "2. Muhammad Somaan\n"
+        "3. Ahmed Ali"
+    );
+    creditsInfo.setCharacterSize(35);
+    creditsInfo.setFillColor(Color::White);
+    creditsInfo.setPosition(
+        (screenwidth - creditsInfo.getLocalBounds().width) / 2,
+        150
+    );
+
+    // Decorative horizontal lines
+    topLine.setSize(Vector2f(screenwidth - 100, 5));
+    topLine.setFillColor(Color::White);
+    topLine.setPosition(50, 120);
+
+    bottomLine.setSize(Vector2f(screenwidth - 100, 5));
+    bottomLine.setFillColor(Color::White);
+    bottomLine.setPosition(50, screenheight - 150);
+}
+
+bool CreditsScene::handle_event(const Event& event, SceneStack& stack) {
+    // Check if the "Back" button was clicked
+    if (backButton.clicked(event) >= 0) {
+        stack.pop(); // Back to the welcome screen, as it was left
+    }
+    return false;
+}
+
+void CreditsScene::draw(RenderTarget& target) const {
+    target.draw(creditsTitle);
+    target.draw(topLine);
+    target.draw(creditsInfo);
+    target.draw(bottomLine);
+    backButton.draw(target);
+}
+
+ResultsScene::ResultsScene(const Font& gameFont) {
+    winnerText.setFont(gameFont); // Set the font for the winner text
+    winnerText.setCharacterSize(60); // Set the font size for visibility
+    winnerText.setFillColor(Color::Yellow); // Set the text color to yellow
+
+    scoreText.setFont(gameFont); // Set the font for the score text
+    scoreText.setCharacterSize(40); // Set font size for emphasis
+    scoreText.setFillColor(Color::White); // Set text color to white
+
+    continueText.setFont(gameFont);
+    continueText.setCharacterSize(20);
+    continueText.setFillColor(Color(160, 160, 160));
+}
+
+void ResultsScene::set_result(const std::string& winner, int leftScore, int rightScore, Time duration) {
+    this->duration = duration;
+
+    // Center the winner text
+    winnerText.setString(winner);
+    FloatRect winnerBounds = winnerText.getLocalBounds();
+    winnerText.setPosition((screenwidth - winnerBounds.width) / 2.0f, screenheight / 3.0f - 50.0f);
+
+    // Center the score text
+    scoreText.setString("Final Score:\nLeft Player: " + std::to_string(leftScore) + "\nRight Player: " + std::to_string(rightScore));
+    FloatRect scoreBounds = scoreText.getLocalBounds();
+    scoreText.setPosition((screenwidth - scoreBounds.width) / 2.0f, screenheight / 2.0f);
+}
+
+void ResultsScene::enter(const Vector2f& /*mousePosition*/) {
+    shownFor.restart();
+    shownSeconds = -1;
+    tick_countdown();
+}
+
+bool ResultsScene::tick_countdown() {
+    // Whole seconds left, rounded up; the text is only re-laid out when it changes
+    Time left = duration - shownFor.getElapsedTime();
+    int seconds = left > Time::Zero ? (left.asMilliseconds() + 999) / 1000 : 0;
+    if (seconds == shownSeconds) {
+        return false;
+    }
+    shownSeconds = seconds;
+    continueText.setString("Press any key to continue (" + std::to_string(seconds) + ")");
+    continueText.setPosition((screenwidth - continueText.getLocalBounds().width) / 2.0f, screenheight - 60.0f);
+    return true;
+}
+
+bool ResultsScene::handle_event(const Event& event, SceneStack& stack) {
+    // Skippable: any key or click continues right away
+    if (event.type == Event::KeyPressed || event.type == Event::MouseButtonPressed) {
+        stack.finish();
+    }
+    return false;
+}
+
+bool ResultsScene::tick(SceneStack& stack) {
+    if (shownFor.getElapsedTime() >= duration) {
+        stack.finish();
+        return false;
+    }
+    return tick_countdown();
+}
+
+void ResultsScene::draw(RenderTarget& target) const {
+    target.draw(winnerText);    // Draw the winner text
+    target.draw(scoreText);     // Draw the score text
+    target.draw(continueText);
+}
+
+MenuScenes::MenuScenes(const Font& gameFont, MatchSettings& settings)
+    : difficulty(gameFont, settings),
+    modeSelection(gameFont, settings, difficulty),
+    credits(gameFont),
+    welcome(gameFont, modeSelection, credits),
+    results(gameFont) {
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <string>
+#include "scene_stack.h"
+#include "widgets.h"
+
+// Drawables of the mode selection screen. Building is kept apart from the
+// event loop so the render benchmark can draw the exact same screen.
+struct ModeSelectionScreen {
+    enum ButtonId { SinglePlayer, Multiplayer, Score15, Score25, Score40, TimerMode }; // Rows of its button table
+
+    sf::Text titleText;
+    sf::Text scoreLimitTitle;
+    ButtonPanel buttons;
+};
+
+void build_mode_selection_screen(ModeSelectionScreen& screen, const sf::Font& gameFont); // Lays out the mode selection screen
+void draw_mode_selection_screen(sf::RenderTarget& target, const ModeSelectionScreen& screen); // Draws it without clearing or displaying
+
+// What the player picked in the menus; copied into the game settings when the menus finish
+struct MatchSettings {
+    bool singlePlayer = false;
+    bool timerMode = false;
+    int targetScore = 15;
+    int difficulty = 0;         // 0 = Easy, 1 = Medium, 2 = Hard, 3 = Expert
+};
+
+// Title screen: Play, Exit and Credits
+class WelcomeScene : public Scene {
+public:
+    WelcomeScene(const sf::Font& gameFont, Scene& playScene, Scene& creditsScene);
+
+    void enter(const sf::Vector2f& mousePosition) override;
+    bool handle_event(const sf::Event& event, SceneStack& stack) override;
+    void draw(sf::RenderTarget& target) const override;
+
+private:
+    enum ButtonId { Play, Exit, Credits };
+
+    Scene& playScene;
+    Scene& creditsScene;
+    sf::Text titleText;
+    ButtonPanel buttons;
+};
+
+// Single player or multiplayer, and the score limit or Timer Mode
+class ModeSelectionScene : public Scene {
+public:
+    ModeSelectionScene(const sf::Font& gameFont, MatchSettings& settings, Scene& difficultyScene);
+
+    void enter(const sf::Vector2f& mousePosition) override;
+    bool handle_event(const sf::Event& event, SceneStack& stack) override;
+    void draw(sf::RenderTarget& target) const override;
+
+private:
+    MatchSettings& settings;
+    Scene& difficultyScene;
+    ModeSelectionScreen screen;
+};
+
+// Easy, Medium, Hard or Expert; picking one finishes the menus
+class DifficultyScene : public Scene {
+public:
+    DifficultyScene(const sf::Font& gameFont, MatchSettings& settings);
+
+    bool handle_event(const sf::Event& event, SceneStack& stack) override;
+    void draw(sf::RenderTarget& target) const override;
+
+private:
+    MatchSettings& settings;
+    sf::Text titleText;
+    ButtonPanel buttons;        // Easy, Medium, Hard, Expert; the row index is the difficulty
+};
+
+// Credits with a Back button
+class CreditsScene : public Scene {
+public:
+    explicit CreditsScene(const sf::Font& gameFont);
+
+    bool handle_event(const sf::Event& event, SceneStack& stack) override;
+    void draw(sf::RenderTarget& target) const override;
+
+private:
+    sf::Text creditsTitle, creditsInfo;
+    sf::RectangleShape topLine, bottomLine;
+    ButtonPanel backButton;
+};
+
+// Winner and final score after a match. It counts down and then finishes the
+// stack by itself, or earlier when the player presses a key or clicks.
+class ResultsScene : public Scene {
+public:
+    explicit ResultsScene(const sf::Font& gameFont);
+
+    // Lays out the texts for one match; a duration of zero finishes on the first tick
+    void set_result(const std::string& winner, int leftScore, int rightScore, sf::Time duration);
+
+    void enter(const sf::Vector2f& mousePosition) override;
+    bool handle_event(const sf::Event& event, SceneStack& stack) override;
+    bool tick(SceneStack& stack) override;
+    sf::Time get_tick_interval() const override { return sf::milliseconds(100); }
+    void draw(sf::RenderTarget& target) const override;
+
+private:
+    bool tick_countdown(); // Updates the countdown text; true if it changed
+
+    sf::Text winnerText, scoreText, continueText;
+    sf::Time duration;
+    sf::Clock shownFor;
+    int shownSeconds = -1;          // Countdown value in continueText
+};
+
+// Every menu screen, built once at startup and reused on each visit
+struct MenuScenes {
+    MenuScenes(const sf::Font& gameFont, MatchSettings& settings);
+
+    DifficultyScene difficulty;
+    ModeSelectionScene modeSelection;
+    CreditsScene credits;
+    WelcomeScene welcome;       // Where the menus start
+    ResultsScene results;       // Shown on its own after each match
+};
@@ -0,0 +1,153 @@
+#include "music_stream.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+using namespace std;
+using namespace sf;
+
+namespace {
+    const size_t ring_samples = 131072; // Power of two
+    const size_t chunk_samples = 4096;  // Handed to SFML per onGetData()
+    const size_t decode_samples = 8192; // Decoded per lock of the file
+}
+
+MusicStream::MusicStream()
+    : ring(ring_samples), chunk(chunk_samples) {
+}
+
+MusicStream::~MusicStream() {
+    stop(); // No more onGetData() calls from here on
+    stop_decoder();
+}
+
+bool MusicStream::open_from_memory(const void* data, size_t size) {
+    stop();
+    stop_decoder();
+    return file.openFromMemory(data, size) && start();
+}
+
+bool MusicStream::open_from_file(const string& path) {
+    stop();
+    stop_decoder();
+    return file.openFromFile(path) && start();
+}
+
+bool MusicStream::start() {
+    const unsigned int channels = file.getChannelCount();
+    if (channels == 0 || chunk_samples % channels != 0) {
+        return false; // Chunks must hold whole frames
+    }
+    initialize(channels, file.getSampleRate());
+
+    readIndex = 0;
+    writeIndex = 0;
+    endOfTrack = false;
+    while (decode_block()) {
+        // Fill the ring here, on the loading thread, so playback starts without an underrun
+    }
+    decoding = true;
+    decoder = thread(&MusicStream::decoder_thread, this);
+    return true;
+}
+
+void MusicStream::set_looping(bool loop) {
+    {
+        lock_guard<mutex> lock(decoderMutex);
+        looping = loop;
+        if (loop && endOfTrack) {
+            file.seek(static_cast<Uint64>(0)); // A short track may already be fully decoded
+            endOfTrack = false;
+        }
+    }
+    wake.notify_one();
+}
+
+void MusicStream::stop_decoder() {
+    if (decoder.joinable()) {
+        {
+            lock_guard<mutex> lock(decoderMutex);
+            decoding = false;
+        }
+        wake.notify_one();
+        decoder.join();
+    }
+}
+
+void MusicStream::decoder_thread() {
+    unique_lock<mutex> lock(decoderMutex);
+    while (decoding) {
+        if (!decode_block()) {
+            wake.wait_for(lock, chrono::milliseconds(20)); // Full (or finished) until playback frees some space
+        }
+    }
+}
+
+bool MusicStream::decode_block() {
+    const size_t write = writeIndex.load(memory_order_relaxed);
+    const size_t space = ring_samples - (write - readIndex.load(memory_order_acquire));
+    if (endOfTrack || space < decode_samples) {
+        return false;
+    }
+
+    // The block may wrap around the end of the ring; read it in up to two pieces
+    const size_t start = write & (ring_samples - 1);
+    const size_t first = min(decode_samples, ring_samples - start);
+    size_t decoded = static_cast<size_t>(file.read(&ring[start], first));
+    if (decoded == first && first < decode_samples) {
+        decoded += static_cast<size_t>(file.read(&ring[0], decode_samples - first));
+    }
+    writeIndex.store(write + decoded, memory_order_release);
+
+    if (decoded < decode_samples) {
+        if (looping && file.getSampleCount() > 0) {
+            file.seek(static_cast<Uint64>(0));
+        }
+        else {
+            endOfTrack = true; // Published after the last samples
+        }
+    }
+    return true;
+}
+
+bool MusicStream::onGetData(Chunk& data) {
+    const bool ended = endOfTrack; // Read first: once it is set, writeIndex is final
+    const size_t read = readIndex.load(memory_order_relaxed);
+    const size_t available = writeIndex.load(memory_order_acquire) - read;
+    if (available == 0 && ended) {
+        return false; // Played to the end
+    }
+
+    // Copy out (the ring wraps, SFML wants one block) and give the space back to the decoder
+    const unsigned int channels = getChannelCount();
+    size_t count = min(available, chunk_samples);
+    count -= count % channels;
+    const size_t start = read & (ring_samples - 1);
+    const size_t first = min(count, ring_samples - start);
+    memcpy(chunk.data(), &ring[start], first * sizeof(Int16));
+    memcpy(chunk.data() + first, &ring[0], (count - first) * sizeof(Int16));
+    readIndex.store(read + count, memory_order_release);
+    wake.notify_one();
+
+    // The decoder fell behind: play silence rather than wait for it
+    if (count < chunk_samples && !ended) {
+        fill(chunk.begin() + count, chunk.end(), static_cast<Int16>(0));
+        count = chunk_samples;
+        underruns.fetch_add(1, memory_order_relaxed);
+    }
+
+    data.samples = chunk.data();
+    data.sampleCount = count;
+    return true;
+}
+
+void MusicStream::onSeek(Time timeOffset) {
+    // SFML has stopped its streaming thread before seeking, so only the decoder can be running
+    {
+        lock_guard<mutex> lock(decoderMutex);
+        file.seek(timeOffset);
+        readIndex.store(writeIndex.load(memory_order_relaxed), memory_order_relaxed); // Drop what was decoded ahead
+        endOfTrack = false;
+    }
+    wake.notify_one();
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <SFML/Audio/InputSoundFile.hpp>
+#include <SFML/Audio/SoundStream.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Background music decoded ahead of playback on its own thread. The decoder fills
+// a fixed ring buffer (about 1.5 s of 44.1 kHz stereo, 256 KB); SFML's streaming
+// thread only copies out of it, so a slow decode never stalls the audio callback,
+// and a stream that falls behind plays silence instead of waiting. Memory stays
+// bounded by the ring however long the track is.
+class MusicStream : public sf::SoundStream {
+public:
+    MusicStream();
+    ~MusicStream();
+
+    // The data must stay valid while the stream is open; it is decoded from in place
+    bool open_from_memory(const void* data, std::size_t size);
+    bool open_from_file(const std::string& path);
+
+    void set_looping(bool loop); // Restart from the beginning at the end of the track
+
+    std::uint64_t get_underruns() const { return underruns.load(std::memory_order_relaxed); } // Chunks played as silence
+
+private:
+    bool onGetData(Chunk& data) override;
+    void onSeek(sf::Time timeOffset) override;
+
+    bool start(); // After the file opened: set up the stream and start decoding
+    void stop_decoder();
+    void decoder_thread();
+    bool decode_block(); // Decodes one block if the ring has room; false if full or finished
+
+    sf::InputSoundFile file;         // Only touched with decoderMutex held
+    std::vector<sf::Int16> ring;     // Decoded samples; power-of-two size
+    std::vector<sf::Int16> chunk;    // What the last onGetData() handed to SFML
+    std::atomic<std::size_t> readIndex{ 0 };  // Consumed by the streaming thread (monotonic)
+    std::atomic<std::size_t> writeIndex{ 0 }; // Produced by the decoder (monotonic)
+    std::atomic<bool> endOfTrack{ false };    // The decoder reached the end and is not looping
+    std::atomic<std::uint64_t> underruns{ 0 };
+
+    std::thread decoder;
+    std::mutex decoderMutex;          // Held while decoding a block, or seeking
+    std::condition_variable wake;     // Ring space freed, a seek, or shutdown
+    bool decoding = false;            // Cleared to stop the decoder thread
+    bool looping = false;
+};
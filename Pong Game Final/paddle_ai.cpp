@@ -0,0 +1,236 @@
+#include "paddle_ai.h"
+#include "game_constants.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace {
+    const float velocity_tolerance = 1e-4f; // adjust_ballspeed() renormalises every tick; ignore rounding
+    const size_t urgent_candidates = 15;  // most_urgent() looks at this many soonest balls
+}
+
+float xorshift_signed(uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return (state >> 8) * (2.0f / 16777216.0f) - 1.0f;
+}
+
+const AiParameters& ai_parameters(int difficulty) {
+    static const AiParameters levels[] = {
+        // speed, reactionMargin, predictionError, reactionTime
+#include "ai_parameters.inc"           // Easy, Medium and Hard, as Pong AI Tuner wrote them
+        { 8.0f, 4.0f, 0.0f, 0.0f },    // Expert: targets come from the LookaheadPlanner
+    };
+    return levels[difficulty >= 0 && difficulty <= 3 ? difficulty : 1]; // Anything else plays Medium
+}
+
+bool predict_intercept(const BallState& ball, float planeX, float& y, float& ticks) {
+    if (ball.vx == 0.0f || (planeX - ball.x) / ball.vx < 0.0f) {
+        return false;
+    }
+    ticks = (planeX - ball.x) / ball.vx;
+
+    // The top edge lives in [0, span]; fold the unbounced path back into it.
+    // Every two spans the path repeats, and the second span runs mirrored.
+    const float span = screenheight - 2.0f * ballradius;
+    float unfolded = fmod(ball.y + ball.vy * ticks, 2.0f * span);
+    if (unfolded < 0.0f) {
+        unfolded += 2.0f * span;
+    }
+    y = unfolded <= span ? unfolded : 2.0f * span - unfolded;
+    return true;
+}
+
+bool InterceptPredictor::target(const BallState& ball, float planeX, float error, float& y) {
+    // Same trajectory: same velocity, and still moving forward along it (a reset jumps back)
+    bool sameTrajectory = cached
+        && abs(ball.vx - last.vx) < velocity_tolerance && abs(ball.vy - last.vy) < velocity_tolerance
+        && (ball.x - last.x) * ball.vx >= 0.0f;
+    last = ball;
+
+    if (!sameTrajectory) {
+        float interceptY, ticks;
+        approaching = predict_intercept(ball, planeX, interceptY, ticks);
+        targetY = interceptY + ballradius + error * random_signed(); // One misjudgement per prediction
+        cached = true;
+        ++solves;
+    }
+
+    y = targetY;
+    return approaching;
+}
+
+float InterceptPredictor::random_signed() {
+    return xorshift_signed(rngState);
+}
+
+void IncomingBallQueue::clear() {
+    heap.clear();
+    slots.clear();
+}
+
+void IncomingBallQueue::update(size_t ball, const BallState& state, float planeX, uint64_t now, float error) {
+    if (ball >= slots.size()) {
+        slots.resize(ball + 1, -1); // Seen even if it is heading away, so get_tracked() counts it
+    }
+
+    float y, ticks;
+    if (!predict_intercept(state, planeX, y, ticks)) {
+        remove(ball);
+        return;
+    }
+
+    Entry entry;
+    entry.arrival = now + static_cast<uint64_t>(ceil(ticks));
+    entry.y = y + ballradius + error * random_signed();
+    entry.ball = static_cast<uint32_t>(ball);
+
+    if (slots[ball] < 0) {
+        heap.push_back(entry);
+        place(heap.size() - 1, entry);
+        sift_up(heap.size() - 1);
+    }
+    else {
+        // Re-key in place; only one of the two sifts moves it
+        size_t index = static_cast<size_t>(slots[ball]);
+        place(index, entry);
+        sift_up(index);
+        sift_down(static_cast<size_t>(slots[ball]));
+    }
+}
+
+void IncomingBallQueue::remove(size_t ball) {
+    if (ball >= slots.size() || slots[ball] < 0) {
+        return;
+    }
+
+    // Move the last entry into the hole, then restore the heap around it
+    size_t index = static_cast<size_t>(slots[ball]);
+    slots[ball] = -1;
+    Entry last = heap.back();
+    heap.pop_back();
+    if (index < heap.size()) {
+        place(index, last);
+        sift_up(index);
+        sift_down(static_cast<size_t>(slots[last.ball]));
+    }
+}
+
+bool IncomingBallQueue::most_urgent(uint64_t now, float paddleCenter, float speed, float& y) const {
+    if (heap.empty()) {
+        return false;
+    }
+
+    // Visit the soonest balls in arrival order: the next one is always the soonest entry
+    // on the frontier (the children of those already visited), which never holds more
+    // than urgent_candidates + 1 entries. The first reachable one is the earliest.
+    // Balls that already passed the plane are lost.
+    size_t frontier[urgent_candidates + 1];
+    size_t open = 0;
+    frontier[open++] = 0;
+    for (size_t visited = 0; visited < urgent_candidates && open > 0; ++visited) {
+        size_t pick = 0;
+        for (size_t i = 1; i < open; ++i) {
+            pick = heap[frontier[i]].arrival < heap[frontier[pick]].arrival ? i : pick;
+        }
+        size_t index = frontier[pick];
+        frontier[pick] = frontier[--open];
+
+        const Entry& entry = heap[index];
+        float distance = abs(entry.y - paddleCenter) - paddleheight / 2.0f;
+        if (entry.arrival >= now && distance <= speed * (entry.arrival - now)) {
+            y = entry.y;
+            return true;
+        }
+        for (size_t child = index * 2 + 1; child <= index * 2 + 2 && child < heap.size(); ++child) {
+            frontier[open++] = child;
+        }
+    }
+    y = heap[0].y;
+    return true;
+}
+
+void IncomingBallQueue::place(size_t index, const Entry& entry) {
+    heap[index] = entry;
+    slots[entry.ball] = static_cast<int32_t>(index);
+}
+
+void IncomingBallQueue::sift_up(size_t index) {
+    Entry entry = heap[index];
+    while (index > 0) {
+        size_t parent = (index - 1) / 2;
+        if (heap[parent].arrival <= entry.arrival) {
+            break;
+        }
+        place(index, heap[parent]);
+        index = parent;
+    }
+    place(index, entry);
+}
+
+void IncomingBallQueue::sift_down(size_t index) {
+    Entry entry = heap[index];
+    const size_t count = heap.size();
+    for (;;) {
+        size_t child = index * 2 + 1;
+        if (child >= count) {
+            break;
+        }
+        if (child + 1 < count && heap[child + 1].arrival < heap[child].arrival) {
+            ++child;
+        }
+        if (entry.arrival <= heap[child].arrival) {
+            break;
+        }
+        place(index, heap[child]);
+        index = child;
+    }
+    place(index, entry);
+}
+
+float IncomingBallQueue::random_signed() {
+    return xorshift_signed(rngState);
+}
+
+void AiController::reset(const AiParameters& parameters) {
+    ai = parameters;
+    // The game's reaction clock let a move through once reactionTime had passed
+    decisionInterval = max(1, static_cast<int>(ceil(ai.reactionTime * sim_tickrate - 1e-3f)));
+    nextDecision = 0;
+    targetY = screenheight / 2.0f;
+    predictor.reset();
+    incoming.clear();
+}
+
+bool AiController::ready(uint64_t tick) {
+    if (tick < nextDecision) {
+        return false;
+    }
+    nextDecision = tick + decisionInterval;
+    return true;
+}
+
+bool AiController::aim(uint64_t tick, float paddleY, const BallState& firstBall, size_t ballCount, float planeX) {
+    // The paddle only moves on decision ticks, so its reach per tick is a fraction of its speed
+    float y;
+    float reach = ai.speed / decisionInterval;
+    bool approaching = ballCount > 1
+        ? incoming.most_urgent(tick, paddleY + paddleheight / 2.0f, reach, y)
+        : ballCount == 1 && predictor.target(firstBall, planeX, ai.predictionError, y);
+    targetY = approaching ? y : screenheight / 2.0f; // Every ball heading away: wait in the middle
+    return approaching;
+}
+
+void AiController::track(size_t ball, const BallState& state, float planeX, uint64_t tick) {
+    incoming.update(ball, state, planeX, tick, ai.predictionError);
+}
+
+float AiController::steer(float paddleY) const {
+    float paddleCenter = paddleY + paddleheight / 2.0f;
+    if (paddleCenter < targetY - ai.reactionMargin) {
+        return ai.speed;
+    }
+    return paddleCenter > targetY + ai.reactionMargin ? -ai.speed : 0.0f;
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "game_constants.h"
+
+// How one difficulty level of the AI plays
+struct AiParameters {
+    float speed;           // Paddle movement per tick, in pixels
+    float reactionMargin;  // Dead zone around the target before the paddle moves
+    float predictionError; // Largest misjudgement of where the ball will arrive, in pixels
+    float reactionTime;    // Seconds between decisions; 0 decides every tick
+};
+
+const AiParameters& ai_parameters(int difficulty); // 0 = Easy, 1 = Medium, 2 = Hard, 3 = Expert
+
+float xorshift_signed(std::uint32_t& state); // Advances a xorshift32 state; uniform in [-1, 1)
+
+// A ball as the simulation moves it: top-left corner and velocity in pixels per tick
+struct BallState {
+    float x = 0.0f, y = 0.0f;
+    float vx = 0.0f, vy = 0.0f;
+};
+
+// Where the ball's top edge will be when its corner reaches planeX, and in how many
+// ticks. Bounces off the top and bottom walls are unfolded in closed form (the path
+// is a straight line on a strip of mirrored playfields), so this is O(1) however
+// many bounces lie ahead. False if the ball is not moving towards planeX.
+bool predict_intercept(const BallState& ball, float planeX, float& y, float& ticks);
+
+// Intercept prediction with the answer cached per trajectory. The cache holds while
+// the ball keeps its velocity and moves along the predicted line, so a new solve
+// (with a new error drawn for it) happens only after a bounce, a speed change or a
+// reset, not every tick. Errors are uniform in [-error, error] pixels.
+class InterceptPredictor {
+public:
+    explicit InterceptPredictor(std::uint32_t seed = 0x2545F491u) : rngState(seed ? seed : 1u) {}
+
+    // Centre y the paddle at planeX should meet the ball at; false while it moves away
+    bool target(const BallState& ball, float planeX, float error, float& y);
+    void reset() { cached = false; }
+
+    std::uint64_t get_solves() const { return solves; } // Predictions actually computed
+
+private:
+    float random_signed(); // Uniform in [-1, 1)
+
+    bool cached = false;
+    bool approaching = false; // The cached solve found an intercept
+    BallState last;           // The ball when the cache was last checked
+    float targetY = 0.0f;     // Cached answer, error included
+    std::uint64_t solves = 0;
+    std::uint32_t rngState;   // xorshift32 state
+};
+
+// Balls heading for one paddle, ordered by the absolute tick they reach its face.
+// An indexed binary min-heap: every ball has a slot, so re-keying a ball after its
+// velocity changed is one O(log n) sift instead of a rebuild, and nothing needs
+// touching on the ticks in between (an absolute arrival tick does not go stale).
+class IncomingBallQueue {
+public:
+    explicit IncomingBallQueue(std::uint32_t seed = 0x6C8E9CF5u) : rngState(seed ? seed : 1u) {}
+
+    void clear();
+
+    // Re-solves one ball at tick now: queued if it is heading for planeX, removed otherwise.
+    // A new error of up to +/- error pixels is drawn for the new prediction.
+    void update(std::size_t ball, const BallState& state, float planeX, std::uint64_t now, float error);
+    void remove(std::size_t ball);
+
+    // Of the 15 soonest balls, the earliest one a paddle centred at paddleCenter moving
+    // speed pixels per tick can still reach; false if none is queued. Falls back to the
+    // soonest ball when none of them is reachable. The 15 are taken from the heap in
+    // arrival order, so this costs the same however many balls are queued.
+    bool most_urgent(std::uint64_t now, float paddleCenter, float speed, float& y) const;
+
+    std::size_t size() const { return heap.size(); }
+    std::size_t get_tracked() const { return slots.size(); } // Balls seen so far, queued or not
+
+private:
+    struct Entry {
+        std::uint64_t arrival; // Tick the ball reaches the plane
+        float y;               // Centre y there, error included
+        std::uint32_t ball;
+    };
+
+    void place(std::size_t index, const Entry& entry); // Writes entry at index and records its slot
+    void sift_up(std::size_t index);
+    void sift_down(std::size_t index);
+    float random_signed(); // Uniform in [-1, 1)
+
+    std::vector<Entry> heap;
+    std::vector<std::int32_t> slots; // Heap index of every ball, or -1 if it is not queued
+    std::uint32_t rngState;          // xorshift32 state
+};
+
+// One AI paddle's state: its parameters, the tick it next acts on, where it is heading
+// and its predictions. It counts simulation ticks and never reads a clock, so a match
+// stepped faster than real time, or many matches on many threads with a controller
+// each, play exactly as the game does at sim_tickrate.
+class AiController {
+public:
+    explicit AiController(std::uint32_t seed = 0x2545F491u) : predictor(seed), incoming(seed ^ 0x49CB6864u) {}
+
+    void reset(const AiParameters& parameters); // A new match: forgets the predictions and acts on the next tick
+
+    // True on the ticks the paddle acts on: the first one, then one every decision
+    // interval (the reaction time in ticks). The paddle holds still in between.
+    bool ready(std::uint64_t tick);
+
+    // Aims at where the ball reaches planeX, or with several balls (tracked with
+    // track()) at the soonest one a paddle with top edge paddleY can still reach.
+    // firstBall is only read when it is the only ball. Heads for the centre when no
+    // ball is coming; false then.
+    bool aim(std::uint64_t tick, float paddleY, const BallState& firstBall, std::size_t ballCount, float planeX);
+    void set_target(float y) { targetY = y; } // Centre y to head for, chosen elsewhere
+
+    // Multiball: re-queues a ball whose trajectory changed at tick
+    void track(std::size_t ball, const BallState& state, float planeX, std::uint64_t tick);
+    std::size_t get_tracked() const { return incoming.get_tracked(); }
+
+    // Offset that moves a paddle with top edge paddleY towards the target, outside the reaction margin
+    float steer(float paddleY) const;
+
+    const AiParameters& get_parameters() const { return ai; }
+    int get_decision_interval() const { return decisionInterval; }
+    float get_target() const { return targetY; }
+
+private:
+    AiParameters ai = {};
+    int decisionInterval = 1;      // Ticks from one decision to the next
+    std::uint64_t nextDecision = 0;
+    float targetY = screenheight / 2.0f;
+    InterceptPredictor predictor;  // One ball: kept until its trajectory changes
+    IncomingBallQueue incoming;    // Several balls: soonest first
+};
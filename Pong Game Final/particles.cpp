@@ -0,0 +1,130 @@
+#include "particles.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+using namespace sf;
+
+namespace {
+    const float particle_size = 3.0f;     // Edge length of a particle quad
+    const float drag_per_second = 0.08f;  // Fraction of velocity kept after one second
+    const float gravity = 300.0f;         // Pulls sparks down a little (pixels / s^2)
+    const int spark_count = 14;           // Particles per paddle hit
+    const int burst_count = 80;           // Particles per goal
+}
+
+ParticleSystem::ParticleSystem(size_t capacity)
+    : capacity(capacity),
+    posX(capacity), posY(capacity),
+    velX(capacity), velY(capacity),
+    life(capacity), maxLife(capacity),
+    color(capacity),
+    vertices(capacity * 4) {
+}
+
+float ParticleSystem::random_unit() {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return (rngState >> 8) * (1.0f / 16777216.0f);
+}
+
+void ParticleSystem::emit(float x, float y, float vx, float vy, float lifetime, Color tint) {
+    size_t i;
+    if (count < capacity) {
+        i = count++; // Append to the dense live range
+    }
+    else {
+        i = recycleCursor; // Pool exhausted: overwrite a live particle, cycling through the pool
+        recycleCursor = (recycleCursor + 1) % capacity;
+    }
+
+    posX[i] = x;
+    posY[i] = y;
+    velX[i] = vx;
+    velY[i] = vy;
+    life[i] = lifetime;
+    maxLife[i] = lifetime;
+    color[i] = tint;
+}
+
+void ParticleSystem::spawn(const EffectRequest& request) {
+    const float pi = 3.14159265f;
+
+    if (request.type == EffectRequest::PaddleSpark) {
+        // Short-lived sparks in a cone pointing away from the paddle
+        for (int n = 0; n < spark_count; ++n) {
+            float angle = (random_unit() - 0.5f) * pi * 0.8f;
+            float speed = 150.0f + 250.0f * random_unit();
+            emit(request.position.x, request.position.y,
+                request.directionX * cos(angle) * speed, sin(angle) * speed,
+                0.25f + 0.2f * random_unit(), Color(255, 230, 120));
+        }
+    }
+    else {
+        // Goal burst: a ring of slower, longer-lived particles
+        for (int n = 0; n < burst_count; ++n) {
+            float angle = 2.0f * pi * random_unit();
+            float speed = 60.0f + 220.0f * random_unit();
+            emit(request.position.x, request.position.y,
+                cos(angle) * speed, sin(angle) * speed,
+                0.6f + 0.5f * random_unit(), Color(120, 200, 255));
+        }
+    }
+}
+
+void ParticleSystem::update(float dt) {
+    const float drag = pow(drag_per_second, dt);
+    const size_t n = count;
+
+    // Integrate. Plain loops over separate float arrays so the compiler vectorizes them.
+    float* px = posX.data();
+    float* py = posY.data();
+    float* vx = velX.data();
+    float* vy = velY.data();
+    float* left = life.data();
+    for (size_t i = 0; i < n; ++i) {
+        vx[i] *= drag;
+        vy[i] = vy[i] * drag + gravity * dt;
+        px[i] += vx[i] * dt;
+        py[i] += vy[i] * dt;
+        left[i] -= dt;
+    }
+
+    // Expire by moving the last live particle into each hole
+    size_t i = 0;
+    while (i < count) {
+        if (life[i] > 0.0f) {
+            ++i;
+            continue;
+        }
+        --count;
+        posX[i] = posX[count];
+        posY[i] = posY[count];
+        velX[i] = velX[count];
+        velY[i] = velY[count];
+        life[i] = life[count];
+        maxLife[i] = maxLife[count];
+        color[i] = color[count];
+    }
+    recycleCursor = min(recycleCursor, count > 0 ? count - 1 : 0);
+
+    // Rebuild the batch in place; the vertex storage was sized for the whole pool up front
+    for (size_t p = 0; p < count; ++p) {
+        Color tint = color[p];
+        tint.a = static_cast<Uint8>(255.0f * max(0.0f, life[p] / maxLife[p])); // Fade out over the lifetime
+
+        Vertex* quad = &vertices[p * 4];
+        quad[0].position = Vector2f(posX[p], posY[p]);
+        quad[1].position = Vector2f(posX[p] + particle_size, posY[p]);
+        quad[2].position = Vector2f(posX[p] + particle_size, posY[p] + particle_size);
+        quad[3].position = Vector2f(posX[p], posY[p] + particle_size);
+        quad[0].color = quad[1].color = quad[2].color = quad[3].color = tint;
+    }
+}
+
+void ParticleSystem::draw(RenderTarget& target) const {
+    if (count > 0) {
+        target.draw(vertices.data(), count * 4, Quads);
+    }
+}
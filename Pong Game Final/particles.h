@@ -0,0 +1,48 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <vector>
+
+// What the simulation asks the renderer to show; passed through an SpscQueue
+struct EffectRequest {
+    enum Type { PaddleSpark, GoalBurst };
+    Type type = PaddleSpark;
+    sf::Vector2f position;      // Where the effect starts, in logical coordinates
+    float directionX = 0.0f;    // Sparks fly mostly this way (+1 right, -1 left)
+};
+
+// Pooled particle system for hit sparks and goal bursts.
+// Particles live in fixed-capacity structure-of-arrays storage that is allocated
+// once. Spawning appends, expiring swaps the last live particle into the hole, so
+// both are O(1) and the live range stays dense for the vectorizable update loop.
+// When the pool is full, new particles recycle existing slots instead of being
+// dropped, so fresh effects stay visible and older ones simply end early.
+class ParticleSystem {
+public:
+    explicit ParticleSystem(std::size_t capacity);
+
+    void spawn(const EffectRequest& request);  // Emits one effect's worth of particles
+    void update(float dt);                     // Advances, expires and re-batches particles (dt in seconds)
+    void draw(sf::RenderTarget& target) const; // One draw call for every live particle
+
+    std::size_t size() const { return count; }
+    std::size_t get_capacity() const { return capacity; }
+
+private:
+    void emit(float x, float y, float vx, float vy, float life, sf::Color color);
+    float random_unit();                       // Uniform in [0, 1)
+
+    std::size_t capacity;
+    std::size_t count = 0;                     // Live particles occupy [0, count)
+    std::size_t recycleCursor = 0;             // Next slot to reuse when the pool is full
+    std::uint32_t rngState = 0x9E3779B9u;      // xorshift32 state
+
+    // Structure of arrays, one entry per particle
+    std::vector<float> posX, posY;
+    std::vector<float> velX, velY;
+    std::vector<float> life, maxLife;          // Seconds left / seconds at spawn
+    std::vector<sf::Color> color;
+
+    std::vector<sf::Vertex> vertices;          // Four per particle, rebuilt in place by update()
+};
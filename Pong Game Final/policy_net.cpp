@@ -0,0 +1,486 @@
+#include "policy_net.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PONG_POLICY_SSE2 1
+#endif
+
+// AVX2 is compiled into every x86 build and only used if the CPU has it: GCC and
+// Clang need the target attribute for that, MSVC accepts the intrinsics as they are
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define PONG_POLICY_AVX2 1
+#define PONG_AVX2_TARGET __attribute__((target("avx2")))
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <immintrin.h>
+#include <intrin.h>
+#define PONG_POLICY_AVX2 1
+#define PONG_AVX2_TARGET
+#endif
+
+using namespace std;
+
+namespace {
+    const size_t row_alignment = 32;  // Weights per AVX2 step; rows and inputs are padded to it
+    const size_t row_group = 4;       // Rows per kernel pass; layers are padded with zero rows to a multiple
+    const uint32_t max_layers = 16;
+    const float arrival_ticks_scale = 1.0f / 1000.0f;
+
+    // Dot products of one int8 input with count weight rows, stride bytes apart.
+    // stride is a multiple of row_alignment, so there is never a tail to handle.
+    typedef void (*DotKernel)(const int8_t* input, const int8_t* rows, size_t stride, size_t count, int32_t* sums);
+
+    void dot_scalar(const int8_t* input, const int8_t* rows, size_t stride, size_t count, int32_t* sums) {
+        for (size_t r = 0; r < count; ++r, rows += stride) {
+            int32_t sum = 0;
+            for (size_t i = 0; i < stride; ++i) {
+                sum += input[i] * rows[i];
+            }
+            sums[r] = sum;
+        }
+    }
+
+#ifdef PONG_POLICY_SSE2
+    // Sign-extends to 16 bits and multiplies pairwise into 32-bit sums; 16 weights per step
+    inline __m128i madd_sse2(__m128i inputLow, __m128i inputHigh, const int8_t* row) {
+        __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row));
+        __m128i low = _mm_madd_epi16(inputLow, _mm_srai_epi16(_mm_unpacklo_epi8(w, w), 8));
+        return _mm_add_epi32(low, _mm_madd_epi16(inputHigh, _mm_srai_epi16(_mm_unpackhi_epi8(w, w), 8)));
+    }
+
+    // Four accumulators in, their four horizontal sums out
+    inline __m128i sum4_sse2(__m128i a, __m128i b, __m128i c, __m128i d) {
+        __m128i ab = _mm_add_epi32(_mm_unpacklo_epi32(a, b), _mm_unpackhi_epi32(a, b));
+        __m128i cd = _mm_add_epi32(_mm_unpacklo_epi32(c, d), _mm_unpackhi_epi32(c, d));
+        return _mm_add_epi32(_mm_unpacklo_epi64(ab, cd), _mm_unpackhi_epi64(ab, cd));
+    }
+
+    // Four rows per pass, so each input block is widened once for all of them
+    void dot_sse2(const int8_t* input, const int8_t* rows, size_t stride, size_t count, int32_t* sums) {
+        size_t r = 0;
+        for (; r + 4 <= count; r += 4, rows += 4 * stride) {
+            __m128i acc0 = _mm_setzero_si128(), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+            for (size_t i = 0; i < stride; i += 16) {
+                __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+                __m128i xLow = _mm_srai_epi16(_mm_unpacklo_epi8(x, x), 8);
+                __m128i xHigh = _mm_srai_epi16(_mm_unpackhi_epi8(x, x), 8);
+                acc0 = _mm_add_epi32(acc0, madd_sse2(xLow, xHigh, rows + i));
+                acc1 = _mm_add_epi32(acc1, madd_sse2(xLow, xHigh, rows + stride + i));
+                acc2 = _mm_add_epi32(acc2, madd_sse2(xLow, xHigh, rows + 2 * stride + i));
+                acc3 = _mm_add_epi32(acc3, madd_sse2(xLow, xHigh, rows + 3 * stride + i));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(sums + r), sum4_sse2(acc0, acc1, acc2, acc3));
+        }
+        if (r < count) {
+            dot_scalar(input, rows, stride, count - r, sums + r);
+        }
+    }
+#endif
+
+#ifdef PONG_POLICY_AVX2
+    // maddubs multiplies unsigned by signed bytes, so the signs move from the input onto
+    // the weights first. Values stay within -127 to 127, so the 16-bit pair sums cannot
+    // saturate. 32 weights per step.
+    PONG_AVX2_TARGET inline __m256i madd_avx2(__m256i inputAbs, __m256i input, const int8_t* row) {
+        __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row));
+        __m256i pairs = _mm256_maddubs_epi16(inputAbs, _mm256_sign_epi8(w, input));
+        return _mm256_madd_epi16(pairs, _mm256_set1_epi16(1));
+    }
+
+    PONG_AVX2_TARGET void dot_avx2(const int8_t* input, const int8_t* rows, size_t stride, size_t count, int32_t* sums) {
+        size_t r = 0;
+        for (; r + 4 <= count; r += 4, rows += 4 * stride) {
+            __m256i acc0 = _mm256_setzero_si256(), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+            for (size_t i = 0; i < stride; i += 32) {
+                __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+                __m256i xAbs = _mm256_sign_epi8(x, x);
+                acc0 = _mm256_add_epi32(acc0, madd_avx2(xAbs, x, rows + i));
+                acc1 = _mm256_add_epi32(acc1, madd_avx2(xAbs, x, rows + stride + i));
+                acc2 = _mm256_add_epi32(acc2, madd_avx2(xAbs, x, rows + 2 * stride + i));
+                acc3 = _mm256_add_epi32(acc3, madd_avx2(xAbs, x, rows + 3 * stride + i));
+            }
+            // Pairwise adds leave row k's sum in element k of each 128-bit half
+            __m256i all = _mm256_hadd_epi32(_mm256_hadd_epi32(acc0, acc1), _mm256_hadd_epi32(acc2, acc3));
+            __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(all), _mm256_extracti128_si256(all, 1));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(sums + r), sum);
+        }
+        if (r < count) {
+            dot_scalar(input, rows, stride, count - r, sums + r);
+        }
+    }
+
+    bool cpu_has_avx2() {
+#if defined(__GNUC__)
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+#else
+        // The CPU must have AVX2 and the OS must save the YMM registers
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) {
+            return false;
+        }
+        __cpuid(info, 1);
+        const int osxsave = 1 << 27, avx = 1 << 28;
+        if ((info[2] & (osxsave | avx)) != (osxsave | avx) || (_xgetbv(0) & 6) != 6) {
+            return false;
+        }
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#endif
+    }
+#endif
+
+    DotKernel kernel_function(PolicyKernel kernel) {
+        switch (kernel) {
+#ifdef PONG_POLICY_AVX2
+        case PolicyKernel::Avx2: return cpu_has_avx2() ? dot_avx2 : nullptr;
+#endif
+#ifdef PONG_POLICY_SSE2
+        case PolicyKernel::Sse2: return dot_sse2;
+#endif
+        case PolicyKernel::Scalar: return dot_scalar;
+        default: return nullptr;
+        }
+    }
+
+    PolicyKernel active_kernel = best_policy_kernel();
+    DotKernel dot = kernel_function(active_kernel);
+
+    size_t padded(size_t count) {
+        return (count + row_alignment - 1) / row_alignment * row_alignment;
+    }
+
+    float centered(float y) {
+        return (y - screenheight / 2.0f) / (screenheight / 2.0f);
+    }
+
+    bool check_shape(size_t layer, size_t layerCount, size_t inputs, size_t outputs, size_t previousOutputs, string& error) {
+        if (inputs == 0 || outputs == 0 || inputs > policy_max_width || outputs > policy_max_width) {
+            error = "Layer " + to_string(layer) + " must have 1 to " + to_string(policy_max_width) + " inputs and outputs";
+        }
+        else if (inputs != (layer == 0 ? policy_observation_size : previousOutputs)) {
+            error = "Layer " + to_string(layer) + " has " + to_string(inputs) + " inputs, expected "
+                + to_string(layer == 0 ? policy_observation_size : previousOutputs);
+        }
+        else if (layer + 1 == layerCount && outputs != policy_action_count) {
+            error = "The last layer must have " + to_string(policy_action_count) + " outputs";
+        }
+        else {
+            return true;
+        }
+        return false;
+    }
+
+    // Rounds to the nearest int8 step, clamped to -127 to 127; SSE2 converts four at a time
+    void quantize(const float* input, size_t count, float inverseScale, int8_t* quantized) {
+        size_t i = 0;
+#ifdef PONG_POLICY_SSE2
+        const __m128 scale = _mm_set1_ps(inverseScale), low = _mm_set1_ps(-127.0f), high = _mm_set1_ps(127.0f);
+        for (; i + 4 <= count; i += 4) {
+            __m128 v = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(input + i), scale), low), high);
+            __m128i q = _mm_cvtps_epi32(v); // Rounds to nearest, like lrintf()
+            q = _mm_packs_epi32(q, q);
+            int32_t packed = _mm_cvtsi128_si32(_mm_packs_epi16(q, q));
+            memcpy(quantized + i, &packed, 4);
+        }
+#endif
+        for (; i < count; ++i) {
+            long q = lrintf(input[i] * inverseScale);
+            quantized[i] = static_cast<int8_t>(min(max(q, -127L), 127L));
+        }
+    }
+
+    // Back to floats: sum * scale + bias, never below floor (0 for ReLU layers).
+    // Branch-free, since the signs of the outputs are as good as random.
+    void dequantize(const int32_t* sums, const float* scale, const float* bias, size_t count, float floor, float* output) {
+        size_t i = 0;
+#ifdef PONG_POLICY_SSE2
+        const __m128 low = _mm_set1_ps(floor);
+        for (; i + 4 <= count; i += 4) {
+            __m128 v = _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(sums + i)));
+            v = _mm_add_ps(_mm_mul_ps(v, _mm_loadu_ps(scale + i)), _mm_loadu_ps(bias + i));
+            _mm_storeu_ps(output + i, _mm_max_ps(v, low));
+        }
+#endif
+        for (; i < count; ++i) {
+            output[i] = max(sums[i] * scale[i] + bias[i], floor);
+        }
+    }
+
+    bool read_bytes(const char*& cursor, const char* end, void* destination, size_t size) {
+        if (static_cast<size_t>(end - cursor) < size) {
+            return false;
+        }
+        memcpy(destination, cursor, size);
+        cursor += size;
+        return true;
+    }
+
+    void append_bytes(vector<char>& file, const void* data, size_t size) {
+        const char* bytes = static_cast<const char*>(data);
+        file.insert(file.end(), bytes, bytes + size);
+    }
+}
+
+void build_observation(const MatchState& match, int side, float* observation) {
+    // Seen from the right: the left paddle's view is mirrored, so its face is the right plane too
+    const float planeX = right_paddle_x - 2 * ballradius;
+    const float ownY = side == 0 ? match.leftPaddleY : match.rightPaddleY;
+    const float opponentY = side == 0 ? match.rightPaddleY : match.leftPaddleY;
+
+    BallState ball;
+    bool approaching = false;
+    float arrivalY = 0.0f, arrivalTicks = 0.0f;
+    for (size_t i = 0; i < match.balls.size(); ++i) {
+        BallState seen = match.balls[i];
+        if (side == 0) {
+            seen.x = screenwidth - 2 * ballradius - seen.x;
+            seen.vx = -seen.vx;
+        }
+        float y, ticks;
+        if (predict_intercept(seen, planeX, y, ticks) && (!approaching || ticks < arrivalTicks)) {
+            ball = seen;
+            approaching = true;
+            arrivalY = y;
+            arrivalTicks = ticks;
+        }
+        else if (i == 0 && !approaching) {
+            ball = seen;
+            arrivalY = seen.y;
+        }
+    }
+
+    observation[0] = centered(ownY + paddleheight / 2.0f);
+    observation[1] = centered(opponentY + paddleheight / 2.0f);
+    observation[2] = (planeX - ball.x) / screenwidth;
+    observation[3] = centered(ball.y + ballradius);
+    observation[4] = ball.vx / match.ballSpeed;
+    observation[5] = ball.vy / match.ballSpeed;
+    observation[6] = centered(arrivalY + ballradius);
+    observation[7] = approaching ? min(arrivalTicks * arrival_ticks_scale, 1.0f) : 1.0f;
+}
+
+PolicyKernel best_policy_kernel() {
+    if (kernel_function(PolicyKernel::Avx2)) {
+        return PolicyKernel::Avx2;
+    }
+    return kernel_function(PolicyKernel::Sse2) ? PolicyKernel::Sse2 : PolicyKernel::Scalar;
+}
+
+bool set_policy_kernel(PolicyKernel kernel) {
+    DotKernel function = kernel_function(kernel);
+    if (!function) {
+        return false;
+    }
+    active_kernel = kernel;
+    dot = function;
+    return true;
+}
+
+PolicyKernel get_policy_kernel() {
+    return active_kernel;
+}
+
+const char* policy_kernel_name(PolicyKernel kernel) {
+    switch (kernel) {
+    case PolicyKernel::Avx2: return "avx2";
+    case PolicyKernel::Sse2: return "sse2";
+    default: return "scalar";
+    }
+}
+
+bool PolicyNet::load(const string& path, string& error) {
+    ifstream in(path, ios::binary);
+    if (!in) {
+        error = "Could not open " + path;
+        return false;
+    }
+    vector<char> file((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    return load_from_memory(file.data(), file.size(), error);
+}
+
+bool PolicyNet::load_from_memory(const void* data, size_t size, string& error) {
+    // Parsed into locals; the net only changes once the whole file checked out
+    const char* cursor = static_cast<const char*>(data);
+    const char* end = cursor + size;
+    PolicyHeader header;
+    if (!read_bytes(cursor, end, &header, sizeof(header)) || memcmp(header.magic, policy_magic, sizeof(policy_magic)) != 0) {
+        error = "Not a policy file";
+        return false;
+    }
+    if (header.version != policy_version || header.layerCount == 0 || header.layerCount > max_layers) {
+        error = "Unsupported policy version or layer count";
+        return false;
+    }
+
+    vector<Layer> loaded;
+    vector<int8_t> packed, row;
+    size_t width = 0;
+    for (uint32_t l = 0; l < header.layerCount; ++l) {
+        PolicyLayerHeader layerHeader;
+        if (!read_bytes(cursor, end, &layerHeader, sizeof(layerHeader))) {
+            error = "Policy file is truncated";
+            return false;
+        }
+        if (!check_shape(l, header.layerCount, layerHeader.inputs, layerHeader.outputs, l > 0 ? loaded.back().outputs : 0, error)) {
+            return false;
+        }
+        if (!(layerHeader.inputScale > 0.0f) || !isfinite(layerHeader.inputScale)) {
+            error = "Layer " + to_string(l) + " has an invalid input scale";
+            return false;
+        }
+
+        Layer layer;
+        layer.inputs = layerHeader.inputs;
+        layer.outputs = layerHeader.outputs;
+        layer.stride = padded(layer.inputs);
+        layer.rows = (layer.outputs + row_group - 1) / row_group * row_group;
+        layer.inverseInputScale = 1.0f / layerHeader.inputScale;
+        layer.relu = layerHeader.relu != 0;
+        layer.weightOffset = packed.size();
+        layer.scale.resize(layer.outputs);
+        layer.bias.resize(layer.outputs);
+        if (!read_bytes(cursor, end, layer.scale.data(), layer.outputs * sizeof(float))
+            || !read_bytes(cursor, end, layer.bias.data(), layer.outputs * sizeof(float))) {
+            error = "Policy file is truncated";
+            return false;
+        }
+
+        // Copy each row into its padded slot; the padding and the extra rows stay zero
+        packed.resize(packed.size() + layer.rows * layer.stride, 0);
+        row.resize(layer.inputs);
+        for (size_t r = 0; r < layer.outputs; ++r) {
+            if (!read_bytes(cursor, end, row.data(), layer.inputs)) {
+                error = "Policy file is truncated";
+                return false;
+            }
+            transform(row.begin(), row.end(), packed.begin() + layer.weightOffset + r * layer.stride,
+                [](int8_t w) { return max<int8_t>(w, -127); }); // -128 would break the AVX2 sign trick
+        }
+        width = max(width, max(layer.stride, padded(layer.outputs)));
+        loaded.push_back(move(layer));
+    }
+    if (cursor != end) {
+        error = "Policy file has trailing data";
+        return false;
+    }
+
+    layers = move(loaded);
+    weights = move(packed);
+    maxWidth = width;
+    return true;
+}
+
+void PolicyNet::prepare(PolicyBuffers& buffers) const {
+    buffers.quantized.assign(maxWidth, 0);
+    buffers.sums.assign(maxWidth, 0);
+    buffers.activations.assign(2 * maxWidth, 0.0f);
+    buffers.width = maxWidth;
+}
+
+PolicyAction PolicyNet::act(const float* observation, PolicyBuffers& buffers) const {
+    const float* input = observation;
+    float* output = nullptr;
+    for (size_t l = 0; l < layers.size(); ++l) {
+        const Layer& layer = layers[l];
+
+        // Quantize the input, zero-padded to the row length
+        int8_t* quantized = buffers.quantized.data();
+        quantize(input, layer.inputs, layer.inverseInputScale, quantized);
+        for (size_t i = layer.inputs; i < layer.stride; ++i) {
+            quantized[i] = 0; // A wider earlier layer may have left values here
+        }
+
+        // Every row's dot product in one kernel call, then back to floats
+        int32_t* sums = buffers.sums.data();
+        dot(quantized, weights.data() + layer.weightOffset, layer.stride, layer.rows, sums);
+        output = buffers.activations.data() + (l % 2) * buffers.width;
+        dequantize(sums, layer.scale.data(), layer.bias.data(), layer.outputs,
+            layer.relu ? 0.0f : -numeric_limits<float>::infinity(), output);
+        input = output;
+    }
+
+    // The highest scoring action; ties go to the earlier one
+    size_t best = 0;
+    for (size_t a = 1; a < policy_action_count; ++a) {
+        if (output[a] > output[best]) {
+            best = a;
+        }
+    }
+    return static_cast<PolicyAction>(best);
+}
+
+void PolicyNet::act_batch(const float* observations, size_t count, PolicyAction* actions, PolicyBuffers& buffers) const {
+    for (size_t i = 0; i < count; ++i) {
+        actions[i] = act(observations + i * policy_observation_size, buffers);
+    }
+}
+
+size_t PolicyNet::get_parameter_count() const {
+    size_t count = 0;
+    for (const Layer& layer : layers) {
+        count += layer.outputs * (layer.inputs + 1);
+    }
+    return count;
+}
+
+bool encode_policy(const vector<PolicyLayerWeights>& layers, vector<char>& file, string& error) {
+    file.clear();
+    if (layers.empty() || layers.size() > max_layers) {
+        error = "A policy needs 1 to " + to_string(max_layers) + " layers";
+        return false;
+    }
+
+    PolicyHeader header;
+    memcpy(header.magic, policy_magic, sizeof(policy_magic));
+    header.version = policy_version;
+    header.layerCount = static_cast<uint32_t>(layers.size());
+    append_bytes(file, &header, sizeof(header));
+
+    vector<float> scale;
+    vector<int8_t> quantized;
+    for (size_t l = 0; l < layers.size(); ++l) {
+        const PolicyLayerWeights& layer = layers[l];
+        if (!check_shape(l, layers.size(), layer.inputs, layer.outputs, l > 0 ? layers[l - 1].outputs : 0, error)) {
+            return false;
+        }
+        if (layer.weights.size() != layer.inputs * layer.outputs || layer.bias.size() != layer.outputs || !(layer.inputScale > 0.0f)) {
+            error = "Layer " + to_string(l) + " has the wrong number of weights or biases, or no input scale";
+            return false;
+        }
+
+        // One symmetric scale per row, so a row of small weights keeps its precision
+        scale.resize(layer.outputs);
+        quantized.resize(layer.weights.size());
+        for (size_t r = 0; r < layer.outputs; ++r) {
+            const float* row = &layer.weights[r * layer.inputs];
+            float largest = 0.0f;
+            for (size_t i = 0; i < layer.inputs; ++i) {
+                largest = max(largest, abs(row[i]));
+            }
+            float step = largest > 0.0f ? largest / 127.0f : 1.0f;
+            for (size_t i = 0; i < layer.inputs; ++i) {
+                quantized[r * layer.inputs + i] = static_cast<int8_t>(lrintf(row[i] / step));
+            }
+            scale[r] = step * layer.inputScale;
+        }
+
+        PolicyLayerHeader layerHeader;
+        layerHeader.inputs = static_cast<uint32_t>(layer.inputs);
+        layerHeader.outputs = static_cast<uint32_t>(layer.outputs);
+        layerHeader.relu = layer.relu ? 1 : 0;
+        layerHeader.inputScale = layer.inputScale;
+        append_bytes(file, &layerHeader, sizeof(layerHeader));
+        append_bytes(file, scale.data(), scale.size() * sizeof(float));
+        append_bytes(file, layer.bias.data(), layer.bias.size() * sizeof(float));
+        append_bytes(file, quantized.data(), quantized.size());
+    }
+    return true;
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "match_state.h"
+
+// Trained paddle policies: a small MLP with int8 weights, run on the CPU.
+// Policy file layout, little-endian:
+//   PolicyHeader
+//   per layer, first to last:
+//     PolicyLayerHeader
+//     float scale[outputs]             (weight scale per output, times the layer's inputScale)
+//     float bias[outputs]
+//     int8  weights[outputs][inputs]   (row-major, symmetric, -127 to 127)
+// A layer quantizes its float input to int8 with inputScale, takes int32 dot products
+// with each weight row, and turns them back into floats with scale and bias. The
+// first layer reads a policy observation; the last one outputs one score per action.
+
+const char policy_magic[8] = { 'P', 'O', 'N', 'G', 'M', 'L', 'P', '1' };
+const uint32_t policy_version = 1;
+const size_t policy_max_width = 1024; // Largest layer accepted
+
+struct PolicyHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t layerCount;
+};
+
+struct PolicyLayerHeader {
+    uint32_t inputs;
+    uint32_t outputs;
+    uint32_t relu;    // 1 to clamp the outputs at zero (hidden layers), 0 for none
+    float inputScale; // Input value of one int8 step
+};
+
+// What a paddle policy sees: the paddle's own side of the match, mirrored for the
+// left paddle so one policy can play either side. Every feature is about -1 to 1.
+//   0 own paddle centre y          1 opponent paddle centre y
+//   2 ball distance from own face  3 ball centre y
+//   4 ball speed towards own side  5 ball vertical speed
+//   6 predicted arrival y          7 ticks until it arrives (1 if it is moving away)
+// The ball is the soonest one heading for the paddle, or the first ball if none is.
+const size_t policy_observation_size = 8;
+void build_observation(const MatchState& match, int side, float* observation); // side 0 = left, 1 = right
+
+// What a policy chooses each decision
+enum PolicyAction {
+    PolicyMoveUp = 0,
+    PolicyStay = 1,
+    PolicyMoveDown = 2,
+};
+const size_t policy_action_count = 3;
+
+// The dot product kernel every policy runs on. The best one the CPU supports is
+// picked at start-up; the others can be selected to compare them.
+enum class PolicyKernel { Scalar, Sse2, Avx2 };
+PolicyKernel best_policy_kernel();
+bool set_policy_kernel(PolicyKernel kernel); // false if this build or CPU cannot run it
+PolicyKernel get_policy_kernel();
+const char* policy_kernel_name(PolicyKernel kernel);
+
+// Working memory for running a policy, sized by PolicyNet::prepare(). One per
+// thread: a decision only writes here, so it never allocates and many threads can
+// share one loaded PolicyNet.
+struct PolicyBuffers {
+    std::vector<std::int8_t> quantized; // One layer's input as int8, zero-padded
+    std::vector<std::int32_t> sums;     // One layer's dot products
+    std::vector<float> activations;     // Two layers' outputs, ping-ponged
+    std::size_t width = 0;              // Stride between the two activation halves
+};
+
+// A loaded policy. Rows are padded to 32 weights and layers to four rows, so the
+// kernels need no tail loops.
+class PolicyNet {
+public:
+    bool load(const std::string& path, std::string& error);
+    bool load_from_memory(const void* data, std::size_t size, std::string& error);
+    bool is_loaded() const { return !layers.empty(); }
+
+    void prepare(PolicyBuffers& buffers) const;
+
+    // Chooses an action from one observation (policy_observation_size floats)
+    PolicyAction act(const float* observation, PolicyBuffers& buffers) const;
+
+    // The same for count agents' observations stored back to back, for batch simulations
+    void act_batch(const float* observations, std::size_t count, PolicyAction* actions, PolicyBuffers& buffers) const;
+
+    std::size_t get_layer_count() const { return layers.size(); }
+    std::size_t get_parameter_count() const; // Weights and biases
+
+private:
+    struct Layer {
+        std::size_t inputs, outputs;
+        std::size_t stride;          // Padded row length
+        std::size_t rows;            // outputs padded to whole kernel passes
+        float inverseInputScale;
+        bool relu;
+        std::size_t weightOffset;    // Into weights
+        std::vector<float> scale, bias;
+    };
+
+    std::vector<Layer> layers;
+    std::vector<std::int8_t> weights; // Every layer's padded rows
+    std::size_t maxWidth = 0;
+};
+
+// A layer in float, as a trainer hands it over; encode_policy() quantizes it
+struct PolicyLayerWeights {
+    std::size_t inputs = 0, outputs = 0;
+    bool relu = false;
+    float inputScale = 1.0f / 127.0f; // Calibrated so the layer's inputs fill the int8 range
+    std::vector<float> weights;       // outputs x inputs, row-major
+    std::vector<float> bias;
+};
+
+// Quantizes float layers into the policy file format (per-row symmetric weights).
+// On failure returns false and describes the problem in error.
+bool encode_policy(const std::vector<PolicyLayerWeights>& layers, std::vector<char>& file, std::string& error);
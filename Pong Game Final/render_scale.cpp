@@ -0,0 +1,76 @@
+#include "render_scale.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace sf;
+
+namespace {
+    const float preset_scales[] = { 1.0f, 0.75f, 0.5f, 0.25f }; // Scales visited by cycle_scale()
+}
+
+RenderScaler::RenderScaler(unsigned int logicalWidth, unsigned int logicalHeight)
+    : logicalWidth(logicalWidth), logicalHeight(logicalHeight) {
+}
+
+void RenderScaler::set_scale(float newScale) {
+    scale = std::min(std::max(newScale, 0.1f), 1.0f); // Never upsample, never go below 10%
+}
+
+void RenderScaler::cycle_scale() {
+    const size_t count = sizeof(preset_scales) / sizeof(preset_scales[0]);
+    for (size_t i = 0; i < count; ++i) {
+        if (scale > preset_scales[i] - 0.01f) {
+            set_scale(preset_scales[(i + 1) % count]); // Move to the next smaller preset
+            return;
+        }
+    }
+    set_scale(preset_scales[0]);
+}
+
+void RenderScaler::set_smooth(bool enabled) {
+    smooth = enabled;
+    texture.setSmooth(smooth);
+}
+
+bool RenderScaler::ensure_texture() {
+    Vector2u wanted(static_cast<unsigned int>(std::lround(logicalWidth * scale)),
+        static_cast<unsigned int>(std::lround(logicalHeight * scale)));
+    if (wanted == textureSize) {
+        return true;
+    }
+
+    if (!texture.create(wanted.x, wanted.y)) {
+        textureSize = Vector2u(); // Try again next frame; draw natively meanwhile
+        return false;
+    }
+    textureSize = wanted;
+    texture.setSmooth(smooth);
+
+    // Keep drawing in logical coordinates; the view maps them onto the smaller texture
+    texture.setView(View(FloatRect(0.0f, 0.0f, static_cast<float>(logicalWidth), static_cast<float>(logicalHeight))));
+
+    sprite.setTexture(texture.getTexture(), true);
+    sprite.setScale(static_cast<float>(logicalWidth) / wanted.x, static_cast<float>(logicalHeight) / wanted.y);
+    return true;
+}
+
+RenderTarget& RenderScaler::begin(RenderTarget& target) {
+    scaled = scale < 1.0f && ensure_texture();
+    if (!scaled) {
+        target.clear(Color::Black);
+        return target;
+    }
+
+    texture.clear(Color::Black);
+    return texture;
+}
+
+void RenderScaler::end(RenderTarget& target) {
+    if (!scaled) {
+        return;
+    }
+
+    // The sprite covers the whole target, so there is nothing underneath to blend with
+    texture.display();
+    target.draw(sprite, RenderStates(BlendNone));
+}
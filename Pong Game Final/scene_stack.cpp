@@ -0,0 +1,114 @@
+#include "scene_stack.h"
+#include <algorithm>
+
+using namespace sf;
+
+SceneStack::SceneStack() {
+    scenes.reserve(8); // Deeper than any menu path, so navigating never allocates
+}
+
+void SceneStack::push(Scene& scene) {
+    scenes.push_back(&scene);
+}
+
+void SceneStack::pop() {
+    if (!scenes.empty()) {
+        scenes.pop_back();
+    }
+}
+
+void SceneStack::replace(Scene& scene) {
+    pop();
+    push(scene);
+}
+
+void SceneStack::finish() {
+    scenes.clear();
+}
+
+void SceneStack::quit() {
+    scenes.clear();
+    quitRequested = true;
+}
+
+bool SceneStack::run(RenderWindow& window) {
+    quitRequested = false;
+    const Scene* shown = nullptr;
+    bool redraw = true;
+    Clock tickClock; // Time since the top scene's last tick
+    Event event;
+
+    while (window.isOpen() && !scenes.empty()) {
+        Scene& scene = *scenes.back();
+
+        // A scene that comes (back) on top starts from the current mouse position
+        if (&scene != shown) {
+            scene.enter(Vector2f(Mouse::getPosition(window)));
+            shown = &scene;
+            redraw = true;
+            tickClock.restart();
+        }
+
+        if (redraw) {
+            window.clear(Color::Black);
+            scene.draw(window);
+            window.display();
+            redraw = false;
+            if (!presented) {
+                firstFrame = std::chrono::steady_clock::now();
+                presented = true;
+            }
+        }
+
+        // Animated scenes tick on a fixed interval, however many events arrive in between
+        Time interval = scene.get_tick_interval();
+        if (interval != Time::Zero && tickClock.getElapsedTime() >= interval) {
+            tickClock.restart();
+            redraw = scene.tick(*this);
+            continue;
+        }
+
+        // Sleep until something happens, or until the next tick is due
+        Time timeout = Time::Zero;
+        if (interval != Time::Zero) {
+            timeout = std::max(interval - tickClock.getElapsedTime(), microseconds(1));
+        }
+        if (!wait_menu_event(window, event, timeout)) {
+            continue;
+        }
+        if (event.type == Event::Closed) {
+            window.close();
+            break;
+        }
+        redraw = needs_redraw(event);
+        redraw = scene.handle_event(event, *this) || redraw;
+    }
+
+    return !quitRequested && window.isOpen();
+}
+
+bool SceneStack::get_first_frame(std::chrono::steady_clock::time_point& time) const {
+    time = firstFrame;
+    return presented;
+}
+
+bool wait_menu_event(Window& window, Event& event, Time timeout) {
+    if (timeout == Time::Zero) {
+        return window.waitEvent(event); // Sleeps in the OS until the next event
+    }
+
+    // SFML has no timed wait, so check for events in short sleeps until the timeout runs out
+    Clock waited;
+    while (!window.pollEvent(event)) {
+        Time left = timeout - waited.getElapsedTime();
+        if (left <= Time::Zero || !window.isOpen()) {
+            return false;
+        }
+        sleep(std::min(left, milliseconds(5)));
+    }
+    return true;
+}
+
+bool needs_redraw(const Event& event) {
+    return event.type == Event::Resized || event.type == Event::GainedFocus;
+}
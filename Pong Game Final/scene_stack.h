@@ -0,0 +1,54 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <chrono>
+#include <vector>
+
+class SceneStack;
+
+// One screen of the menu flow. Scenes are built once and live as long as the
+// menus do; the stack only holds pointers to them, so visiting a screen again
+// reuses its drawables instead of rebuilding them.
+class Scene {
+public:
+    virtual ~Scene() {}
+
+    virtual void enter(const sf::Vector2f& /*mousePosition*/) {}              // Became the top scene; sync hover state
+    virtual bool handle_event(const sf::Event& event, SceneStack& stack) = 0; // True if the screen needs a redraw
+    virtual bool tick(SceneStack& /*stack*/) { return false; }                // Tick interval elapsed; true if it needs a redraw
+    virtual sf::Time get_tick_interval() const { return sf::Time::Zero; }    // Zero = static, sleep until an event
+    virtual void draw(sf::RenderTarget& target) const = 0;                    // Draws without clearing or displaying
+};
+
+// Navigation between scenes, driven from a single loop in run(). Going back is a
+// pop, so the call stack does not grow however often the player moves around.
+class SceneStack {
+public:
+    SceneStack();
+
+    void push(Scene& scene);    // Shows scene on top of the current one
+    void pop();                 // Returns to the scene below
+    void replace(Scene& scene); // Swaps the current scene for another
+    void finish();              // Leaves run() normally (e.g. the player picked a match)
+    void quit();                // Leaves run() because the player asked to exit
+
+    bool empty() const { return scenes.empty(); }
+    bool get_first_frame(std::chrono::steady_clock::time_point& time) const; // When run() first presented a frame, if it has
+
+    // Runs the top scene until the stack is empty. It sleeps on window events,
+    // waking early only for scenes with a tick interval, and redraws only when a
+    // scene reports a change. Returns false if the player quit or closed the window.
+    bool run(sf::RenderWindow& window);
+
+private:
+    std::vector<Scene*> scenes;
+    bool quitRequested = false;
+    bool presented = false;
+    std::chrono::steady_clock::time_point firstFrame;
+};
+
+// Menu event pump. Menus are static between events, so instead of polling and
+// redrawing every iteration they sleep until something happens and redraw only
+// when it changed what is on screen.
+bool wait_menu_event(sf::Window& window, sf::Event& event, sf::Time timeout = sf::Time::Zero); // Blocks for the next event; with a timeout, returns false once it expires
+bool needs_redraw(const sf::Event& event); // True for events after which the window contents may have been lost
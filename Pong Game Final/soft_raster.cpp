@@ -0,0 +1,171 @@
+#include "soft_raster.h"
+#include "game_constants.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PONG_RASTER_SSE2 1
+#endif
+
+using namespace std;
+
+namespace {
+    const uint8_t background_level = 0;    // Empty playfield
+    const uint8_t object_level = 255;      // Paddles and balls
+    const uint8_t bar_level = 128;         // Score bars
+    const float bar_height = 8.0f;         // Score bar thickness in logical pixels
+
+    // Per-call drawing context: byte layout plus the logical-to-pixel scale
+    struct Canvas {
+        uint8_t* pixels;
+        int width;
+        int height;
+        int stride;
+        int bytesPerPixel;
+        float scaleX;
+        float scaleY;
+    };
+
+    // Fills count gray pixels; 16 per store with SSE2
+    void fill_span_gray(uint8_t* dst, int count, uint8_t value) {
+#ifdef PONG_RASTER_SSE2
+        const __m128i v = _mm_set1_epi8(static_cast<char>(value));
+        for (; count >= 16; count -= 16, dst += 16) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), v);
+        }
+#endif
+        memset(dst, value, count);
+    }
+
+    // Fills count RGB pixels with the same level on every channel.
+    // 16 RGB pixels are exactly three 16-byte stores, so the pattern never shifts.
+    void fill_span_rgb(uint8_t* dst, int count, uint8_t value) {
+#ifdef PONG_RASTER_SSE2
+        const __m128i v = _mm_set1_epi8(static_cast<char>(value));
+        for (; count >= 16; count -= 16, dst += 48) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), v);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), v);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 32), v);
+        }
+#endif
+        memset(dst, value, count * 3);
+    }
+
+    void fill_span(const Canvas& canvas, int y, int x0, int x1, uint8_t value) {
+        x0 = max(x0, 0);
+        x1 = min(x1, canvas.width);
+        if (y < 0 || y >= canvas.height || x0 >= x1) {
+            return;
+        }
+
+        uint8_t* row = canvas.pixels + static_cast<ptrdiff_t>(y) * canvas.stride + x0 * canvas.bytesPerPixel;
+        if (canvas.bytesPerPixel == 1) {
+            fill_span_gray(row, x1 - x0, value);
+        }
+        else {
+            fill_span_rgb(row, x1 - x0, value);
+        }
+    }
+
+    // First pixel whose center lies at or after a logical coordinate
+    int to_pixel(float logical, float scale) {
+        return static_cast<int>(ceil(logical * scale - 0.5f));
+    }
+
+    // Axis-aligned rectangle in logical coordinates, sampled at pixel centers
+    void fill_rect(const Canvas& canvas, float left, float top, float width, float height, uint8_t value) {
+        int x0 = to_pixel(left, canvas.scaleX);
+        int x1 = to_pixel(left + width, canvas.scaleX);
+        int y0 = to_pixel(top, canvas.scaleY);
+        int y1 = to_pixel(top + height, canvas.scaleY);
+
+        // Keep thin objects visible at very low resolutions
+        if (x1 == x0) ++x1;
+        if (y1 == y0) ++y1;
+
+        for (int y = max(y0, 0); y < min(y1, canvas.height); ++y) {
+            fill_span(canvas, y, x0, x1, value);
+        }
+    }
+
+    // Ball as an ellipse (the scale may differ per axis), one span per row
+    void fill_ball(const Canvas& canvas, float left, float top, uint8_t value) {
+        const float cx = (left + ballradius) * canvas.scaleX;
+        const float cy = (top + ballradius) * canvas.scaleY;
+        const float rx = ballradius * canvas.scaleX;
+        const float ry = ballradius * canvas.scaleY;
+
+        int y0 = max(static_cast<int>(floor(cy - ry)), 0);
+        int y1 = min(static_cast<int>(ceil(cy + ry)), canvas.height);
+        bool drewAny = false;
+        for (int y = y0; y < y1; ++y) {
+            float dy = (y + 0.5f - cy) / ry;
+            if (dy * dy >= 1.0f) {
+                continue;
+            }
+            float half = rx * sqrt(1.0f - dy * dy);
+            int x0 = static_cast<int>(ceil(cx - half - 0.5f));
+            int x1 = static_cast<int>(ceil(cx + half - 0.5f));
+            if (x1 > x0) {
+                fill_span(canvas, y, x0, x1, value);
+                drewAny = true;
+            }
+        }
+
+        // A ball smaller than a pixel still lights the pixel under its center
+        if (!drewAny) {
+            int x = static_cast<int>(floor(cx));
+            fill_span(canvas, static_cast<int>(floor(cy)), x, x + 1, value);
+        }
+    }
+}
+
+void rasterize_snapshot(const GameSnapshot& snapshot, const RasterTarget& target) {
+    Canvas canvas;
+    canvas.pixels = target.pixels;
+    canvas.width = target.width;
+    canvas.height = target.height;
+    canvas.bytesPerPixel = target.format == PixelFormat::RGB24 ? 3 : 1;
+    canvas.stride = target.stride > 0 ? target.stride : target.width * canvas.bytesPerPixel;
+    canvas.scaleX = static_cast<float>(target.width) / screenwidth;
+    canvas.scaleY = static_cast<float>(target.height) / screenheight;
+
+    // Clear; one fill for tightly packed buffers, one per row otherwise
+    if (canvas.stride == canvas.width * canvas.bytesPerPixel) {
+        if (canvas.bytesPerPixel == 1) {
+            fill_span_gray(canvas.pixels, canvas.width * canvas.height, background_level);
+        }
+        else {
+            fill_span_rgb(canvas.pixels, canvas.width * canvas.height, background_level);
+        }
+    }
+    else {
+        for (int y = 0; y < canvas.height; ++y) {
+            fill_span(canvas, y, 0, canvas.width, background_level);
+        }
+    }
+
+    // Score bars along the top edge, growing inwards from each side towards the middle
+    if (snapshot.targetScore > 0) {
+        float half = screenwidth / 2.0f;
+        float leftLength = half * min(1.0f, static_cast<float>(snapshot.leftScore) / snapshot.targetScore);
+        float rightLength = half * min(1.0f, static_cast<float>(snapshot.rightScore) / snapshot.targetScore);
+        if (snapshot.leftScore > 0) {
+            fill_rect(canvas, 0.0f, 0.0f, leftLength, bar_height, bar_level);
+        }
+        if (snapshot.rightScore > 0) {
+            fill_rect(canvas, screenwidth - rightLength, 0.0f, rightLength, bar_height, bar_level);
+        }
+    }
+
+    // Paddles
+    fill_rect(canvas, snapshot.leftPaddle.x, snapshot.leftPaddle.y, paddlewidth, paddleheight, object_level);
+    fill_rect(canvas, snapshot.rightPaddle.x, snapshot.rightPaddle.y, paddlewidth, paddleheight, object_level);
+
+    // Balls
+    for (const auto& ball : snapshot.balls) {
+        fill_ball(canvas, ball.x, ball.y, object_level);
+    }
+}
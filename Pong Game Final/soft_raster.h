@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+#include "game_snapshot.h"
+
+// Tiny CPU rasterizer for pixel observations on machines without a GL context.
+// Draws paddles, balls and score bars from a GameSnapshot into a caller-owned
+// buffer at any resolution (e.g. 84x84). It never allocates, so it is safe to
+// call from many simulation threads at once.
+
+enum class PixelFormat {
+    Gray8,   // One byte per pixel
+    RGB24    // Three bytes per pixel, R G B
+};
+
+struct RasterTarget {
+    std::uint8_t* pixels = nullptr; // First byte of the top row
+    int width = 0;                  // In pixels
+    int height = 0;                 // In pixels
+    int stride = 0;                 // Bytes between rows; 0 means tightly packed
+    PixelFormat format = PixelFormat::Gray8;
+};
+
+// Renders one observation. Gray8 uses 0 for the background, 255 for paddles and
+// balls and 128 for the score bars; RGB24 uses the same levels on every channel.
+void rasterize_snapshot(const GameSnapshot& snapshot, const RasterTarget& target);
@@ -0,0 +1,185 @@
+#include "sound_mixer.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PONG_MIXER_SSE 1
+#include <emmintrin.h>
+#else
+#define PONG_MIXER_SSE 0
+#endif
+
+using namespace std;
+using namespace sf;
+
+namespace {
+    const size_t chunk_frames = 512; // Frames mixed per onGetData(), a multiple of 4 (about 12 ms at 44.1 kHz)
+    const float min_pitch = 0.25f;
+    const float max_pitch = 4.0f;
+}
+
+SoundMixer::SoundMixer(size_t voiceCount, unsigned int sampleRate)
+    : sampleRate(sampleRate), voices(max<size_t>(voiceCount, 1)),
+    left(chunk_frames), right(chunk_frames), output(chunk_frames * 2) {
+    initialize(2, sampleRate);
+}
+
+SoundMixer::~SoundMixer() {
+    stop(); // The streaming thread must be done with our buffers before they go
+}
+
+int SoundMixer::add_sound(const Int16* samples, size_t sampleCount, unsigned int channelCount, unsigned int soundRate) {
+    // The voices point into sounds, so the list is fixed once the stream is playing
+    const size_t frames = channelCount > 0 ? sampleCount / channelCount : 0;
+    if (frames == 0 || getStatus() != Stopped) {
+        return -1;
+    }
+
+    MixerSound sound;
+    sound.rateRatio = static_cast<float>(soundRate) / sampleRate;
+    sound.samples.resize(frames + 2, 0.0f);
+    for (size_t i = 0; i < frames; ++i) {
+        int sum = 0;
+        for (unsigned int c = 0; c < channelCount; ++c) {
+            sum += samples[i * channelCount + c]; // Down-mixed to mono; pan places it
+        }
+        sound.samples[i] = sum / (32768.0f * channelCount);
+    }
+    sounds.push_back(move(sound));
+    return static_cast<int>(sounds.size() - 1);
+}
+
+bool SoundMixer::trigger(int sound, float gain, float pitch, float pan) {
+    VoiceRequest request;
+    request.sound = sound;
+    request.gain = gain;
+    request.pitch = pitch;
+    request.pan = pan;
+    return requests.push(request);
+}
+
+bool SoundMixer::onGetData(Chunk& data) {
+    VoiceRequest request;
+    while (requests.pop(request)) {
+        start_voice(request);
+    }
+
+    fill(left.begin(), left.end(), 0.0f);
+    fill(right.begin(), right.end(), 0.0f);
+    unsigned int active = 0;
+    for (Voice& voice : voices) {
+        if (voice.sound) {
+            mix_voice(voice, chunk_frames);
+            ++active;
+        }
+    }
+    activeVoices.store(active, memory_order_relaxed);
+
+    // Clip and interleave into 16-bit stereo
+#if PONG_MIXER_SSE
+    const __m128 scale = _mm_set1_ps(32767.0f);
+    const __m128 lower = _mm_set1_ps(-1.0f), upper = _mm_set1_ps(1.0f);
+    for (size_t f = 0; f < chunk_frames; f += 4) {
+        __m128 l = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(&left[f]), lower), upper);
+        __m128 r = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(&right[f]), lower), upper);
+        __m128i low = _mm_cvtps_epi32(_mm_mul_ps(_mm_unpacklo_ps(l, r), scale));  // l0 r0 l1 r1
+        __m128i high = _mm_cvtps_epi32(_mm_mul_ps(_mm_unpackhi_ps(l, r), scale)); // l2 r2 l3 r3
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&output[f * 2]), _mm_packs_epi32(low, high));
+    }
+#else
+    for (size_t f = 0; f < chunk_frames; ++f) {
+        output[f * 2] = static_cast<Int16>(lround(min(max(left[f], -1.0f), 1.0f) * 32767.0f));
+        output[f * 2 + 1] = static_cast<Int16>(lround(min(max(right[f], -1.0f), 1.0f) * 32767.0f));
+    }
+#endif
+
+    // Always more to play: silence keeps the stream (and its latency) steady between effects
+    data.samples = output.data();
+    data.sampleCount = output.size();
+    return true;
+}
+
+void SoundMixer::onSeek(Time /*timeOffset*/) {
+    // A live mix has no position to seek to
+}
+
+void SoundMixer::start_voice(const VoiceRequest& request) {
+    if (request.sound < 0 || static_cast<size_t>(request.sound) >= sounds.size()) {
+        return;
+    }
+
+    // A free voice, or else the one that has been playing longest
+    Voice* target = nullptr;
+    Voice* oldest = nullptr;
+    for (Voice& voice : voices) {
+        if (!voice.sound) {
+            target = &voice;
+            break;
+        }
+        if (!oldest || voice.started < oldest->started) {
+            oldest = &voice;
+        }
+    }
+    if (!target) {
+        target = oldest;
+        stolenVoices.fetch_add(1, memory_order_relaxed);
+    }
+
+    // Equal-power pan keeps the loudness constant across the field
+    const MixerSound& sound = sounds[request.sound];
+    const float angle = (min(max(request.pan, -1.0f), 1.0f) + 1.0f) * 0.25f * 3.14159265f;
+    target->sound = &sound;
+    target->position = 0.0;
+    target->step = min(max(request.pitch, min_pitch), max_pitch) * sound.rateRatio;
+    target->leftGain = request.gain * cos(angle);
+    target->rightGain = request.gain * sin(angle);
+    target->started = ++voicesStarted;
+}
+
+void SoundMixer::mix_voice(Voice& voice, size_t frames) {
+    // Frames until the voice runs off the end of its sound (the two padding zeros are not played)
+    const size_t end = voice.sound->samples.size() - 2;
+    const size_t remaining = static_cast<size_t>(ceil((end - voice.position) / voice.step));
+    const size_t count = min(frames, remaining);
+
+    // Positions within this chunk are small offsets from base, so floats keep them exact enough
+    const size_t base = static_cast<size_t>(voice.position);
+    const float offset = static_cast<float>(voice.position - base);
+    const float* samples = voice.sound->samples.data() + base;
+    const float step = voice.step;
+
+    size_t f = 0;
+#if PONG_MIXER_SSE
+    const __m128 lanes = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+    const __m128 steps = _mm_mul_ps(lanes, _mm_set1_ps(step));
+    const __m128 leftGain = _mm_set1_ps(voice.leftGain);
+    const __m128 rightGain = _mm_set1_ps(voice.rightGain);
+    alignas(16) int indices[4];
+    for (; f + 4 <= count; f += 4) {
+        // Linear interpolation between the two source samples around each position
+        __m128 position = _mm_add_ps(_mm_set1_ps(offset + f * step), steps);
+        __m128i index = _mm_cvttps_epi32(position);
+        __m128 fraction = _mm_sub_ps(position, _mm_cvtepi32_ps(index));
+        _mm_store_si128(reinterpret_cast<__m128i*>(indices), index);
+        __m128 a = _mm_set_ps(samples[indices[3]], samples[indices[2]], samples[indices[1]], samples[indices[0]]);
+        __m128 b = _mm_set_ps(samples[indices[3] + 1], samples[indices[2] + 1], samples[indices[1] + 1], samples[indices[0] + 1]);
+        __m128 value = _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), fraction));
+
+        _mm_storeu_ps(&left[f], _mm_add_ps(_mm_loadu_ps(&left[f]), _mm_mul_ps(value, leftGain)));
+        _mm_storeu_ps(&right[f], _mm_add_ps(_mm_loadu_ps(&right[f]), _mm_mul_ps(value, rightGain)));
+    }
+#endif
+    for (; f < count; ++f) {
+        float position = offset + f * step;
+        size_t index = static_cast<size_t>(position);
+        float fraction = position - index;
+        float value = samples[index] + (samples[index + 1] - samples[index]) * fraction;
+        left[f] += value * voice.leftGain;
+        right[f] += value * voice.rightGain;
+    }
+
+    voice.position += count * static_cast<double>(step);
+    if (count < frames || voice.position >= end) {
+        voice.sound = nullptr; // Finished; free for the next trigger
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <SFML/Audio/SoundStream.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "spsc_queue.h"
+
+// Software mixer for sound effects: one stereo SoundStream (one OpenAL source)
+// that plays any number of overlapping sounds from a fixed pool of voices.
+// Voices are mixed with SSE into a float accumulator on SFML's streaming thread;
+// when every voice is busy, a new sound takes over the one that started first.
+//
+// Sounds are registered with add_sound() before play(). After that, trigger()
+// only pushes a request onto a lock-free queue, so it is cheap enough for any
+// one producer thread; the streaming thread starts the voices.
+class SoundMixer : public sf::SoundStream {
+public:
+    explicit SoundMixer(std::size_t voiceCount = 32, unsigned int sampleRate = 44100);
+    ~SoundMixer();
+
+    // Interleaved 16-bit samples, copied as mono float; returns the sound's id, or -1 if empty
+    int add_sound(const sf::Int16* samples, std::size_t sampleCount, unsigned int channelCount, unsigned int sampleRate);
+
+    // Starts sound id on a free (or the oldest) voice. gain scales the volume, pitch
+    // the playback rate (2 = an octave up), pan places it from -1 (left) to 1 (right).
+    // Single producer; returns false if the request queue is full.
+    bool trigger(int sound, float gain = 1.0f, float pitch = 1.0f, float pan = 0.0f);
+
+    unsigned int get_active_voices() const { return activeVoices.load(std::memory_order_relaxed); } // As of the last mixed chunk
+    std::uint64_t get_stolen_voices() const { return stolenVoices.load(std::memory_order_relaxed); } // Cut off to make room
+
+private:
+    struct MixerSound {
+        std::vector<float> samples; // Mono, with two trailing zeros so interpolation never reads past the end
+        float rateRatio;            // Sound sample rate over the mixer's
+    };
+
+    struct VoiceRequest {
+        int sound;
+        float gain, pitch, pan;
+    };
+
+    struct Voice {
+        const MixerSound* sound = nullptr; // Null while free
+        double position = 0.0;             // In source samples
+        float step = 1.0f;                 // Source samples per output frame
+        float leftGain = 0.0f, rightGain = 0.0f;
+        std::uint64_t started = 0;         // Start order, for stealing the oldest
+    };
+
+    bool onGetData(Chunk& data) override;
+    void onSeek(sf::Time timeOffset) override;
+
+    void start_voice(const VoiceRequest& request);
+    void mix_voice(Voice& voice, std::size_t frames);
+
+    unsigned int sampleRate;
+    std::vector<MixerSound> sounds;
+    std::vector<Voice> voices;
+    std::uint64_t voicesStarted = 0;
+    SpscQueue<VoiceRequest, 256> requests;
+
+    // Mixing buffers, allocated once
+    std::vector<float> left, right;
+    std::vector<sf::Int16> output;   // Interleaved stereo handed to SFML
+
+    std::atomic<unsigned int> activeVoices{ 0 };
+    std::atomic<std::uint64_t> stolenVoices{ 0 };
+};
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+// Fixed-capacity lock-free queue for exactly one producer thread and one consumer thread.
+// Storage is a plain array, so pushing and popping never allocate. A full queue
+// rejects the push instead of blocking; the producer decides what to drop.
+template <typename T, std::size_t Capacity>
+class SpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+public:
+    // Producer side; returns false if the queue is full
+    bool push(const T& item) {
+        const std::size_t tail = tailIndex.load(std::memory_order_relaxed);
+        if (tail - headIndex.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+        items[tail & (Capacity - 1)] = item;
+        tailIndex.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side; returns false if the queue is empty
+    bool pop(T& item) {
+        const std::size_t head = headIndex.load(std::memory_order_relaxed);
+        if (head == tailIndex.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = items[head & (Capacity - 1)];
+        headIndex.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    T items[Capacity];
+    alignas(64) std::atomic<std::size_t> headIndex{ 0 }; // Next slot to read (consumer)
+    alignas(64) std::atomic<std::size_t> tailIndex{ 0 }; // Next slot to write (producer)
+};
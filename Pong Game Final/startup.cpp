@@ -0,0 +1,44 @@
+#include "startup.h"
+#include "logger.h"
+#include <algorithm>
+
+using namespace std;
+
+StartupTimeline::StartupTimeline() : origin(clock::now()) {
+    steps.reserve(16);
+}
+
+void StartupTimeline::mark(const char* step) {
+    clock::time_point now = clock::now();
+    record(step, now, now);
+}
+
+void StartupTimeline::record(const char* step, clock::time_point started, clock::time_point finished) {
+    Step entry = { step, since_origin(started), since_origin(finished) };
+    lock_guard<mutex> lock(stepsMutex);
+    steps.push_back(entry);
+}
+
+double StartupTimeline::since_origin(clock::time_point time) const {
+    return chrono::duration<double, milli>(time - origin).count();
+}
+
+void StartupTimeline::report() const {
+    vector<Step> ordered;
+    {
+        lock_guard<mutex> lock(stepsMutex);
+        ordered = steps;
+    }
+    stable_sort(ordered.begin(), ordered.end(), [](const Step& a, const Step& b) { return a.finishedMs < b.finishedMs; });
+
+    LOG_INFO("Startup timeline:");
+    for (const Step& step : ordered) {
+        double took = step.finishedMs - step.startedMs;
+        if (took > 0.0) {
+            LOG_INFO("  %8.1f ms  %s (took %.1f ms)", step.finishedMs, step.name, took);
+        }
+        else {
+            LOG_INFO("  %8.1f ms  %s", step.finishedMs, step.name);
+        }
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <vector>
+
+// Start-up timeline: when each step finished (relative to the start of main, so
+// the first frame's entry is the time to first frame) and how long asset loads
+// took on their worker threads. Steps may be recorded
+// from any thread; report() logs them in the order they finished.
+class StartupTimeline {
+public:
+    typedef std::chrono::steady_clock clock;
+
+    StartupTimeline();
+
+    void mark(const char* step);                                 // A step on the calling thread finished now
+    void record(const char* step, clock::time_point started, clock::time_point finished); // A step with its own duration
+
+    // Runs load() on a worker thread and records how long it took; the future holds its result
+    template <typename Load>
+    std::future<bool> load_async(const char* asset, Load load) {
+        return std::async(std::launch::async, [this, asset, load]() {
+            clock::time_point started = clock::now();
+            bool loaded = load();
+            record(asset, started, clock::now());
+            return loaded;
+        });
+    }
+
+    void report() const; // Logs every step in the order they finished
+
+private:
+    struct Step {
+        const char* name;
+        double startedMs;   // Since origin
+        double finishedMs;
+    };
+
+    double since_origin(clock::time_point time) const;
+
+    clock::time_point origin;
+    mutable std::mutex stepsMutex; // Workers record concurrently with the main thread
+    std::vector<Step> steps;
+};
@@ -2,22 +2,39 @@
 #include <SFML/Window.hpp>
 #include <SFML/System.hpp>
 #include <SFML/Audio.hpp>
-#include <iostream>
+#include <string>
 #include <cstdlib> // For rand()
+#include <cmath>
 #include <vector>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <future>
+#include <cstring>
+#include "asset_bundle.h"
+#include "audio.h"
+#include "frame_pacer.h"
+#include "game_constants.h"
+#include "game_events.h"
+#include "game_render.h"
+#include "game_snapshot.h"
+#include "key_state.h"
+#include "logger.h"
+#include "lookahead_planner.h"
+#include "match_state.h"
+#include "menus.h"
+#include "paddle_ai.h"
+#include "particles.h"
+#include "policy_net.h"
+#include "render_scale.h"
+#include "scene_stack.h"
+#include "spsc_queue.h"
+#include "startup.h"
+#include "triple_buffer.h"
 
 using namespace std;
 using namespace sf;
 
-// Constants
-const int screenwidth = 800;             // Screen width
-const int screenheight = 600;            // Screen height
-const float paddlewidth = 20.0f;         // Paddle width
-const float paddleheight = 100.0f;       // Paddle height
-const float ballradius = 10.0f;          // Radius of the ball                  
-const float initial_ballspeed = 0.5f;     // Initial ball speed
-                    
-
 // Global variables
 float ball_speed = 0;                   // Ball speed (initially set to 0)
 int targetscore = 15;                   // Target score for winning
@@ -25,152 +42,353 @@ RectangleShape left_paddle, right_paddle;  // Paddle objects for left and right
 vector<CircleShape> balls;               // Vector of balls for multiplayer/multi-ball mode
 vector<float> ballSpeedX, ballSpeedY;    // X and Y speeds for each ball
 int left_score = 0, right_score = 0;       // Scores for left and right players
+AssetBundle asset_bundle;                 // Mapped pong_assets.pak; declared first so it outlives everything loaded from it
 Font game_font;                           // Font for displaying text
 int missed_balls = 0;                     // Count of missed balls
 bool is_singleplayer = false;             // Flag for single-player mode
 int selected_mode = 0;                   // Selected mode (single/multiplayer)
-int difficulty = 0;                      // Difficulty level (0 = Easy, 1 = Medium, 2 = Hard)
-Clock game_clock;                         // Timer clock for timing
+int difficulty = 0;                      // Difficulty level (0 = Easy, 1 = Medium, 2 = Hard, 3 = Expert)
 const int time_limit = 60;                // Time limit in seconds for Timer Mode
 bool is_timermode = false;                // Indicates if Timer Mode is active
-float paddle_speed = 1.0f;                // Speed of the paddles
+
+// Simulation thread state
+const chrono::nanoseconds sim_tick_duration(1000000000LL / sim_tickrate); // Length of one tick
+TripleBuffer<GameSnapshot> snapshots;     // Finished ticks handed from the simulation to the renderer
+atomic<bool> sim_running(false);          // Cleared by the render thread to stop the simulation
+uint64_t sim_tick = 0;                    // Ticks simulated in the current match (drives Timer Mode)
+bool match_over = false;                  // Set by the simulation once a winner is decided
+string match_winner;                      // Winner text for the results screen
+GameEventBuffer<256> tick_events;         // Events raised by the tick being simulated
+SpscQueue<GameEvent, 1024> event_queue;   // Finished ticks' events, consumed in batches by the render thread
+uint64_t events_undelivered = 0;          // Events event_queue was too full to take (simulation thread only)
+KeyState key_state;                       // Keyboard state fed by window events (late latching reads it)
+SpscQueue<InputEvent, 256> input_queue;   // Paddle key transitions, in order, for the simulation
+const Keyboard::Key paddle_keys[4] = { Keyboard::W, Keyboard::S, Keyboard::Up, Keyboard::Down }; // Left up/down, right up/down
+bool paddle_key_held[4] = {};             // Paddle keys as the simulation has applied them
+AiController ai_controller;               // The AI paddle's parameters, decision timing and predictions
+LookaheadPlanner ai_planner;              // Expert: plays candidate moves ahead on copies of the match
+PaddlePlan ai_plan;                       // Expert: the plan being followed
+bool ai_plan_ready = false;               // Expert: ai_plan is for the current trajectories
+uint64_t ai_plan_tick = 0;                // Tick the latest plan was started from
+bool ai_replan = true;                    // A ball's trajectory changed since the latest plan was started
+MatchState ai_match;                      // The match as the Expert and policy AIs see it, refreshed in place
+PolicyNet ai_policy;                      // Trained policy from --ai-policy; replaces the hand-tuned AI when loaded
+PolicyBuffers ai_policy_buffers;          // Its working memory, sized once at load
 
 // Function prototypes
 void initialize_game();                   // Initializes game settings
 void reset_ball(int index);               // Resets a specific ball to the center
 void handle_paddle_movement(float paddleSpeed); // Handles paddle movement
 float adjust_paddle_speed();               // Adjusts paddle speed dynamically
-void draw_score(RenderWindow& window, int score, bool isLeft); // Draws score on the screen
-void handleinput(RenderWindow& window); // Handles player input
-void check_collisions(RenderWindow& window); // Checks and handles collisions
-void show_welcome_window(RenderWindow& window, Font& gameFont); // Displays the welcome window
-void show_mode_selectionwindow(RenderWindow& window, Font& gameFont); // Displays mode selection window
+void handleinput();                       // Handles player input
+void check_collisions();                  // Checks and handles collisions
 void ai_movement();                       // Handles AI paddle movement in single-player mode
 void adjust_ballspeed(size_t ballIndex);  // Dynamically adjusts ball speed
-void show_difficulty_window(RenderWindow& window, Font& gameFont); // Displays difficulty selection window
-void check_game_end(RenderWindow& window); // Checks if the game has ended
-void display_winner(RenderWindow& window, const string& winner, int leftScore, int rightScore); // Displays winner
+BallState ball_state(size_t index);       // A ball's position and velocity as the AI sees them
+float ai_plane_x();                       // Where the AI paddle meets the ball
+void capture_match(MatchState& match);    // Copies the match into plain data the AI can play ahead on
+void track_incoming_balls();              // Re-queues the balls whose trajectory changed this tick
+void check_game_end();                    // Checks if the game has ended
 void restart_game(RenderWindow& window, Font& gameFont); // Restarts the game
+void end_match(const string& winner);     // Records the winner and stops the simulation
+bool pump_events(RenderWindow& window, RenderScaler& scaler, FramePacer& pacer); // Handles match events; true if a paddle key changed
+void apply_input_events(bool (&moving)[4]); // Applies queued key transitions; moving[] is what moves this tick
+LatchedPaddles latch_paddles(const GameSnapshot& snapshot); // Extrapolates local paddles from the freshest input
+void capture_snapshot(GameSnapshot& snapshot); // Copies the match state into a snapshot
+void simulate_tick();                     // Advances the match by one tick
+void simulation_thread();                 // Runs simulate_tick() at sim_tickrate and publishes snapshots
+void raise_event(GameEvent::Type type, int ball, int side, Vector2f position); // Records an event for the current tick
+bool effect_for(const GameEvent& event, EffectRequest& effect); // Particle effect shown for an event, if any
+
+int main(int argc, char* argv[]) {
+    StartupTimeline startup; // Reported once the menus are done
+    // Playfield render resolution (lower it on software-GL machines)
+    RenderScaler scaler(screenwidth, screenheight);
+    bool lateLatch = true; // Re-sample local paddles right before each frame is drawn
+    FramePacer pacer(60);  // Frame rate cap; 0 = uncapped
+    Time resultsTime = seconds(5); // How long the results screen stays up unless skipped
+    const char* logPath = nullptr; // Log file; stderr if not given
+    const char* policyPath = nullptr; // Trained AI policy; the hand-tuned AI if not given
+    bool audioEnabled = true;      // False runs silent without ever opening the audio device
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--render-scale") == 0 && i + 1 < argc) {
+            scaler.set_scale(static_cast<float>(atof(argv[++i]))); // e.g. 0.5 draws the playfield at 400x300
+        }
+        else if (strcmp(argv[i], "--smooth") == 0) {
+            scaler.set_smooth(true); // Linear instead of nearest upscaling
+        }
+        else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+            pacer.set_target(atoi(argv[++i])); // e.g. 60, 120, 144, 240, or 0 for uncapped benchmarking
+        }
+        else if (strcmp(argv[i], "--results-seconds") == 0 && i + 1 < argc) {
+            resultsTime = seconds(static_cast<float>(atof(argv[++i]))); // 0 skips the results screen
+        }
+        else if (strcmp(argv[i], "--no-late-latch") == 0) {
+            lateLatch = false; // For comparing input-to-screen latency
+        }
+        else if (strcmp(argv[i], "--no-audio") == 0) {
+            audioEnabled = false; // For machines without an audio device
+        }
+        else if (strcmp(argv[i], "--ai-policy") == 0 && i + 1 < argc) {
+            policyPath = argv[++i]; // A policy file written by encode_policy()
+        }
+        else if (strcmp(argv[i], "--log-file") == 0 && i + 1 < argc) {
+            logPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--log-level") == 0 && i + 1 < argc) {
+            LogLevel level;
+            if (log_parse_level(argv[++i], level)) {
+                log_set_level(level); // debug, info, warning or error
+            }
+        }
+    }
 
-SoundBuffer hitBuffer;               // Sound buffer for paddle hit sound
-Sound hitSound;                      // Sound effect for paddle hits
-
-int main() {
-    // Load font for displaying text
-    if (!game_font.loadFromFile("Arial.ttf")) {
-        cout << "Error: Could not load font!" << endl;
-        return -1;
+    // Logging runs on its own thread from here on; nothing below waits on console or file output
+    if (!log_start(logPath)) {
+        LOG_WARNING("Could not open log file %s; logging to stderr", logPath);
     }
 
-    // Load background music
-    Music backgroundMusic;
-    if (!backgroundMusic.openFromFile("pong_music.ogg.opus")) {
-        std::cerr << "Error loading background music!" << std::endl;
+    if (policyPath) {
+        string error;
+        if (ai_policy.load(policyPath, error)) {
+            ai_policy.prepare(ai_policy_buffers);
+            LOG_INFO("AI policy %s: %u layers, %u parameters, %s kernel", policyPath, static_cast<unsigned int>(ai_policy.get_layer_count()),
+                static_cast<unsigned int>(ai_policy.get_parameter_count()), policy_kernel_name(get_policy_kernel()));
+        }
+        else {
+            LOG_ERROR("Could not load AI policy: %s", error.c_str());
+        }
     }
 
-    // Load paddle hit sound effect
-    if (!hitBuffer.loadFromFile("ballsound.ogg")) {
-        std::cerr << "Error: Could not load paddle hit sound!" << std::endl;
+    // Map the asset bundle next to the executable (or in the working directory), so the
+    // game starts from anywhere; without one the loose files in the working directory are used
+    if (asset_bundle.open(executable_directory(argv[0]) + bundle_file_name) || asset_bundle.open(bundle_file_name)) {
+        startup.mark("asset bundle mapped");
+    }
+    else {
+        LOG_WARNING("No %s found; loading loose asset files", bundle_file_name);
     }
-    hitSound.setVolume(100);
-    hitSound.setBuffer(hitBuffer);
 
+    // Load assets on worker threads while the window and GL context come up.
+    // Only the font is needed for the first menu frame; the sounds can finish later.
+    // The audio device is opened by whichever of them is used first, not before main
+    OpenAlAudio openAlAudio;
+    NullAudio nullAudio;
+    AudioBackend& audio = audioEnabled ? static_cast<AudioBackend&>(openAlAudio) : nullAudio;
+    SoundSamples hitSamples; // Paddle hit sound effect
+    future<bool> fontLoad = startup.load_async("font", [] {
+        AssetView font; // Slices of the mapped bundle are handed to SFML without a copy
+        return asset_bundle.find("Arial.ttf", font) ? game_font.loadFromMemory(font.data, font.size)
+            : game_font.loadFromFile("Arial.ttf"); // Font for displaying text
+        });
+    future<bool> musicLoad = startup.load_async("music", [&audio] {
+        AssetView music; // Decoded straight from the mapping while it plays
+        bool opened = asset_bundle.find("pong_music.ogg.opus", music) ? audio.open_music(music.data, music.size)
+            : audio.open_music("pong_music.ogg.opus");
+        if (!opened) {
+            return false;
+        }
 
-    // Configure background music
-    backgroundMusic.setLoop(true);       // Loop the music
-    backgroundMusic.setVolume(50);       // Set volume
-    backgroundMusic.play();              // Start playing music
+        // Background music loops from as soon as it is ready, behind the menus
+        audio.play_music(50);
+        return true;
+        });
+    future<bool> hitSoundLoad = startup.load_async("hit sound", [&hitSamples] {
+        AssetView sound; // Decoded here; the mixer keeps its own copy
+        return asset_bundle.find("ballsound.ogg", sound) ? decode_sound(sound.data, sound.size, hitSamples)
+            : decode_sound("ballsound.ogg", hitSamples);
+        });
 
     RenderWindow window(VideoMode(screenwidth, screenheight), "Pong Game");
+    window.setKeyRepeatEnabled(false); // Held keys are tracked by KeyState; repeats would only add events
+    startup.mark("window created");
+
+    if (!fontLoad.get()) {
+        LOG_ERROR("Could not load font!");
+        log_stop();
+        return -1;
+    }
+
+    // Menus: welcome, credits, mode and difficulty selection, all driven from one scene loop
+    MatchSettings settings;
+    MenuScenes menus(game_font, settings);
+    SceneStack sceneStack;
+    sceneStack.push(menus.welcome);
+    startup.mark("menus built");
+    bool play = sceneStack.run(window);
+
+    // The sounds have had the whole menu visit to load
+    if (!musicLoad.get()) {
+        LOG_ERROR("Could not load background music!");
+    }
+    if (!hitSoundLoad.get()) {
+        LOG_ERROR("Could not load paddle hit sound!");
+    }
+
+    chrono::steady_clock::time_point firstFrame;
+    if (sceneStack.get_first_frame(firstFrame)) {
+        startup.record("first menu frame", firstFrame, firstFrame);
+    }
+    startup.report();
+
+    if (!play) {
+        log_stop();
+        return 0; // Exit button or window closed
+    }
 
-    // Show welcome screen and difficulty selection before starting the game
-    show_welcome_window(window, game_font);
-    show_difficulty_window(window, game_font);
+    // Sound effects play through one mixed stream, so overlapping hits in multiball all sound
+    int hitSound = audio.add_effect(hitSamples);
+    audio.start_effects();
+
+    // Start the match with what the player picked
+    is_singleplayer = settings.singlePlayer;
+    is_timermode = settings.timerMode;
+    targetscore = settings.targetScore;
+    difficulty = settings.difficulty;
+    initialize_game();
+
+    // Render-side drawables for the match (paddles, balls, scores and timer)
+    GameRenderer renderer(game_font, scaler);
+
+    // Start the simulation on its own thread; from here on the render thread only reads snapshots
+    GameSnapshot previous;
+    capture_snapshot(previous);
+    GameSnapshot current = previous;
+    for (bool& held : paddle_key_held) {
+        held = false;
+    }
+    sim_running = true;
+    thread simThread(simulation_thread);
+
+    // Particle effects live on the render thread; the pool is allocated once here
+    ParticleSystem particles(4096);
+    MatchStats stats;
+    Clock frameClock;
 
-    // Timer text configuration
-    Text timerText;
-    timerText.setFont(game_font);
-    timerText.setCharacterSize(30);
-    timerText.setFillColor(Color::White);
-    timerText.setPosition(380, 10);      // Position of timer text
+    // Input-to-screen latency: from a paddle key event to the end of the first present showing it
+    bool inputPending = false;
+    chrono::steady_clock::time_point inputTime;
+    double latencyTotal = 0.0, latencyWorst = 0.0;
+    int latencySamples = 0;
 
-    // Main game loop
+    // Main render loop
     while (window.isOpen()) {
-        Event event;
-        while (window.pollEvent(event)) {
-            if (event.type == Event::Closed)
-                window.close(); // Close window if the user exits
-        }
-
-        // Timer Mode logic
-        if (is_timermode) {
-            Time elapsedTime = game_clock.getElapsedTime();
-            int remainingTime = time_limit - static_cast<int>(elapsedTime.asSeconds());
-            if (remainingTime <= 0) { // If time is up
-                string winner;
-                if (left_score > right_score) {
-                    winner = "Left Player Wins!";
-                }
-                else if (right_score > left_score) {
-                    winner = is_singleplayer ? "Left Player Wins" : "AI Wins!";
-                }
-                else {
-                    winner = "It's a Tie!";
-                }
+        if (pump_events(window, scaler, pacer) && !inputPending) {
+            inputPending = true;
+            inputTime = chrono::steady_clock::now();
+        }
 
-                display_winner(window, winner, left_score, right_score);
-                break; // End the game
-            }
+        // Pick up the newest tick, keeping the one before it for interpolation
+        if (snapshots.update()) {
+            previous = current;
+            current = snapshots.read_buffer();
+        }
 
-            // Update timer display
-            int minutes = remainingTime / 60;
-            int seconds = remainingTime % 60;
-            timerText.setString(std::to_string(minutes) + ":" + (seconds < 10 ? "0" : "") + std::to_string(seconds));
+        // React to what the simulation reported since the last frame: particles, sound and stats
+        GameEvent event;
+        EffectRequest effect;
+        while (event_queue.pop(event)) {
+            stats.record(event);
+            if (effect_for(event, effect)) {
+                particles.spawn(effect);
+            }
+            if (event.type == GameEvent::PaddleHit && hitSound >= 0) {
+                // Every hit gets its own voice: faster balls sound higher, and the hit is panned to its paddle
+                float pitch = min(max(event.speed / 1.2f, 0.75f), 1.5f);
+                float pan = event.position.x / screenwidth * 2.0f - 1.0f;
+                audio.play_effect(hitSound, 1.0f, pitch, pan);
+            }
         }
 
-        // Check if any player has reached the target score
-        if (left_score >= targetscore || right_score >= targetscore) {
-            cout << "Game Over! Final Score: Left " << left_score << " - Right " << right_score << endl;
-            window.close();
-            break;
+        // The simulation has stopped itself once a winner is known
+        if (current.matchOver) {
+            simThread.join();
+            LOG_INFO("Game Over! Final Score: Left %d - Right %d", current.leftScore, current.rightScore);
+            break; // End the game; the results screen follows below
         }
 
-        // Handle input and game logic
-        handleinput(window);
+        // Advance every particle
+        particles.update(min(frameClock.restart().asSeconds(), 0.1f));
 
-        // Clear screen and redraw game objects
-        window.clear(Color::Black);
-        window.draw(left_paddle);
-        window.draw(right_paddle);
+        // Blend between the two newest snapshots based on how long ago the newest one arrived
+        float alpha = 1.0f;
+        auto span = current.published - previous.published;
+        if (span.count() > 0) {
+            alpha = chrono::duration<float>(chrono::steady_clock::now() - current.published) / span;
+            alpha = min(max(alpha, 0.0f), 1.0f);
+        }
 
-        // Draw balls
-        for (const auto& ball : balls) {
-            window.draw(ball);
+        // Late latching: pick up input that arrived while this frame was prepared and
+        // place the local paddles from it, instead of waiting for the simulation
+        LatchedPaddles latched;
+        if (lateLatch) {
+            if (pump_events(window, scaler, pacer) && !inputPending) {
+                inputPending = true;
+                inputTime = chrono::steady_clock::now();
+            }
+            latched = latch_paddles(current);
         }
 
-        // Draw scores
-        draw_score(window, left_score, true);
-        draw_score(window, right_score, false);
+        renderer.draw(window, previous, current, alpha, &particles, lateLatch ? &latched : nullptr);
+        pacer.wait(); // Hold the frame until it is due, then present
+        window.display();
 
-        // Draw timer if active
-        if (is_timermode) {
-            window.draw(timerText);
+        // The input is on screen once it was latched, or once the simulation has applied it
+        if (inputPending && (lateLatch || current.published >= inputTime)) {
+            double latency = chrono::duration<double, milli>(chrono::steady_clock::now() - inputTime).count();
+            latencyTotal += latency;
+            latencyWorst = max(latencyWorst, latency);
+            ++latencySamples;
+            inputPending = false;
         }
+    }
 
-        // Update ball movement and speed
-        for (size_t i = 0; i < balls.size(); ++i) {
-            adjust_ballspeed(i); // Adjust speed dynamically
-            balls[i].move(ballSpeedX[i], ballSpeedY[i]); // Move ball
-        }
+    // Frame pacing report
+    PacingStats pacing = pacer.get_stats();
+    if (pacing.frames > 0) {
+        LOG_INFO("Frame pacing at %d Hz: %lld frames, error avg %.3f ms, jitter %.3f ms, worst %.3f ms, %lld late",
+            pacer.get_target(), pacing.frames, pacing.meanErrorMs, pacing.stddevErrorMs, pacing.worstErrorMs, pacing.missedFrames);
+    }
 
-        // Check collisions and game end conditions
-        check_collisions(window);
-        check_game_end(window);
+    LOG_INFO("Match stats: %d paddle hits, %d wall bounces, %d goals, longest rally %d",
+        stats.paddleHits, stats.wallBounces, stats.goals, stats.longestRally);
+    audio.log_stats();
 
-        // Display everything
-        window.display();
+    if (latencySamples > 0) {
+        LOG_INFO("Input-to-screen latency (late latching %s): avg %.2f ms, worst %.2f ms over %d inputs",
+            lateLatch ? "on" : "off", latencyTotal / latencySamples, latencyWorst, latencySamples);
+    }
+
+    // Stop the simulation if the window was closed mid-match
+    sim_running = false;
+    if (simThread.joinable()) {
+        simThread.join();
+    }
+    if (tick_events.get_dropped() > 0) {
+        LOG_WARNING("Match stats incomplete: %llu events did not fit a tick's event buffer and were dropped",
+            static_cast<unsigned long long>(tick_events.get_dropped()));
+    }
+    if (events_undelivered > 0) {
+        LOG_WARNING("Match stats incomplete: %llu events were dropped because the renderer fell behind",
+            static_cast<unsigned long long>(events_undelivered));
+    }
+    if (ai_planner.get_rollouts() > 0) {
+        LOG_INFO("Expert AI: %llu rollouts on %u threads", static_cast<unsigned long long>(ai_planner.get_rollouts()),
+            static_cast<unsigned int>(ai_planner.get_thread_count()));
     }
 
+    // Results screen: a scene on the menu loop, so the window keeps pumping events and it can be skipped
+    if (current.matchOver && window.isOpen()) {
+        if (resultsTime > Time::Zero) {
+            menus.results.set_result(current.winner, current.leftScore, current.rightScore, resultsTime);
+            sceneStack.push(menus.results);
+            sceneStack.run(window);
+        }
+        restart_game(window, game_font); // Restart the game
+        window.close(); // Close the window after displaying the winner
+    }
+
+    log_stop();
     return 0;
 }
 
@@ -190,7 +408,6 @@ void initialize_game() {
     // Timer Mode-specific setup
     if (is_timermode) {
         targetscore = 1000; // Set the target score for Timer Mode
-        game_clock.restart(); // Restart the game timer
     }
 
     // Set the initial ball speed based on the selected difficulty level
@@ -203,7 +420,8 @@ void initialize_game() {
         initialspeed = 1.2f; // Medium difficulty
         break;
     case 2: 
-        initialspeed = 1.6f; // Hard difficulty
+    case 3:
+        initialspeed = 1.6f; // Hard and Expert difficulty
         break;
     default: 
         initialspeed = 1.3f; // Default to medium difficulty
@@ -229,6 +447,16 @@ void initialize_game() {
     left_score = 0; // Reset left player score
     right_score = 0; // Reset right player score
     missed_balls = 0; // Reset the number of missed balls
+
+    // Start a fresh match clock
+    sim_tick = 0; // Timer Mode counts simulation ticks
+    tick_events.reset_dropped();
+    events_undelivered = 0;
+    ai_controller.reset(ai_parameters(difficulty));
+    ai_replan = true;
+    ai_plan_ready = false;
+    match_over = false;
+    match_winner.clear();
 }
 
 void reset_ball(int index) {
@@ -244,167 +472,24 @@ void reset_ball(int index) {
     balls[index].setPosition(screenwidth / 2.0f - ballradius, screenheight / 2.0f - ballradius); // Place the ball at the center of the screen
 }
 
-void show_difficulty_window(RenderWindow& window, Font& gameFont) {
-    const int screenWidth = 800;
-    const int screenHeight = 600;
-
-    // Title Text
-    Text titleText;
-    titleText.setFont(gameFont);
-    titleText.setString("Select Difficulty"); // Set the title text
-    titleText.setCharacterSize(50); // Set the font size
-    titleText.setFillColor(Color::White); // Set the text color to white
-    titleText.setPosition((screenWidth - titleText.getLocalBounds().width) / 2, 100); // Center the title at the top
-
-    // Easy Button Setup
-    RectangleShape easyButton(Vector2f(200, 50)); // Create a rectangular button
-    easyButton.setFillColor(Color::Green); // Set button color to green
-    easyButton.setPosition(screenWidth / 2 - 100, screenHeight / 2 - 70); // Center the button
-
-    Text easyText;
-    easyText.setFont(gameFont); // Set the font
-    easyText.setString("Easy"); // Set button text
-    easyText.setCharacterSize(30); // Set font size
-    easyText.setFillColor(Color::White); // Set text color
-    easyText.setPosition(easyButton.getPosition().x + 60, easyButton.getPosition().y + 5); // Position text on the button
-
-    // Medium Button Setup
-    RectangleShape mediumButton(Vector2f(200, 50)); // Create a rectangular button
-    mediumButton.setFillColor(Color::Yellow); // Set button color to yellow
-    mediumButton.setPosition(screenWidth / 2 - 100, screenHeight / 2 + 20); // Center the button
-
-    Text mediumText;
-    mediumText.setFont(gameFont); // Set the font
-    mediumText.setString("Medium"); // Set button text
-    mediumText.setCharacterSize(30); // Set font size
-    mediumText.setFillColor(Color::Black); // Set text color
-    mediumText.setPosition(mediumButton.getPosition().x + 45, mediumButton.getPosition().y + 5); // Position text on the button
-
-    // Hard Button Setup
-    RectangleShape hardButton(Vector2f(200, 50)); // Create a rectangular button
-    hardButton.setFillColor(Color::Red); // Set button color to red
-    hardButton.setPosition(screenWidth / 2 - 100, screenHeight / 2 + 110); // Center the button
-
-    Text hardText;
-    hardText.setFont(gameFont); // Set the font
-    hardText.setString("Hard"); // Set button text
-    hardText.setCharacterSize(30); // Set font size
-    hardText.setFillColor(Color::White); // Set text color
-    hardText.setPosition(hardButton.getPosition().x + 55, hardButton.getPosition().y + 5); // Position text on the button
-
-    while (window.isOpen()) {
-        Event event;
-        while (window.pollEvent(event)) {
-            if (event.type == Event::Closed) {
-                window.close(); // Close the window if the close button is pressed
-                return;
-            }
-            if (event.type == Event::MouseButtonPressed && event.mouseButton.button == Mouse::Left) {
-                Vector2f mousePosition(event.mouseButton.x, event.mouseButton.y);
-
-                // Check if the Easy button is clicked
-                if (easyButton.getGlobalBounds().contains(mousePosition)) {
-                    difficulty = 0; // Set difficulty to Easy
-                    initialize_game(); // Initialize the game
-                    return;
-                }
-                // Check if the Medium button is clicked
-                else if (mediumButton.getGlobalBounds().contains(mousePosition)) {
-                    difficulty = 1; // Set difficulty to Medium
-                    initialize_game(); // Initialize the game
-                    return;
-                }
-                // Check if the Hard button is clicked
-                else if (hardButton.getGlobalBounds().contains(mousePosition)) {
-                    difficulty = 2; // Set difficulty to Hard
-                    initialize_game(); // Initialize the game
-                    return;
-                }
-            }
-        }
-
-        // Render the difficulty selection window
-        window.clear();
-        window.draw(titleText); // Draw the title text
-        window.draw(easyButton); // Draw the Easy button
-        window.draw(easyText); // Draw the Easy button text
-        window.draw(mediumButton); // Draw the Medium button
-        window.draw(mediumText); // Draw the Medium button text
-        window.draw(hardButton); // Draw the Hard button
-        window.draw(hardText); // Draw the Hard button text
-        window.display();
-    }
-}
-
 void adjust_ballspeed(size_t ballIndex) {
     // Set the ball speed based on the difficulty level
-    switch (difficulty) {
-    case 0: ball_speed = 0.8f; break; // Easy difficulty
-    case 2: ball_speed = 1.6f; break; // Hard difficulty
-    default: ball_speed = 1.2f; break; // Medium or default difficulty
-    }
-
-    // Apply the speed adjustment to all balls
-    for (size_t i = 0; i < balls.size(); ++i) {
-        // Normalize the initial direction vector
-        float directionX = ballSpeedX[i] / std::sqrt(ballSpeedX[i] * ballSpeedX[i] + ballSpeedY[i] * ballSpeedY[i]);
-        float directionY = ballSpeedY[i] / std::sqrt(ballSpeedX[i] * ballSpeedX[i] + ballSpeedY[i] * ballSpeedY[i]);
+    ball_speed = ball_speed_for(difficulty);
 
-        // Scale the direction vector to the target speed
-        ballSpeedX[i] = directionX * ball_speed;
-        ballSpeedY[i] = directionY * ball_speed;
-    }
+    // Keep the ball's direction and scale it to that speed
+    BallState ball = ball_state(ballIndex);
+    normalize_ball_speed(ball, ball_speed);
+    ballSpeedX[ballIndex] = ball.vx;
+    ballSpeedY[ballIndex] = ball.vy;
 }
 
 float adjust_paddle_speed() {
     // Adjust paddle speed based on the current difficulty level
-    switch (difficulty) {
-    case 0: // Easy difficulty
-        return paddle_speed; // Slower paddle for easier gameplay
-    case 2: // Hard difficulty
-        return paddle_speed + 1.5f; // Faster paddle for harder gameplay
-    default: // Medium or default difficulty
-        return paddle_speed + 0.8f; // Default speed for medium difficulty
-    }
+    return player_paddle_speed_for(difficulty);
 }
 
 
-void display_winner(RenderWindow& window, const string& winner, int leftScore, int rightScore) {
-    // Prepare the winner text
-    Text winnerText;
-    winnerText.setFont(game_font); // Set the font for the winner text
-    winnerText.setCharacterSize(60); // Set the font size for visibility
-    winnerText.setFillColor(Color::Yellow); // Set the text color to yellow
-    winnerText.setString(winner); // Set the winner string
-
-    // Center the winner text
-    FloatRect winnerBounds = winnerText.getLocalBounds();
-    winnerText.setPosition((screenwidth - winnerBounds.width) / 2.0f, screenheight / 3.0f - 50.0f);
-
-    // Prepare the score text
-    Text scoreText;
-    scoreText.setFont(game_font); // Set the font for the score text
-    scoreText.setCharacterSize(40); // Set font size for emphasis
-    scoreText.setFillColor(Color::White); // Set text color to white
-    scoreText.setString("Final Score:\nLeft Player: " + std::to_string(leftScore) + "\nRight Player: " + std::to_string(rightScore));
-
-    // Center the score text
-    FloatRect scoreBounds = scoreText.getLocalBounds();
-    scoreText.setPosition((screenwidth - scoreBounds.width) / 2.0f, screenheight / 2.0f);
-
-    // Display the winner screen
-    window.clear(Color::Black); // Set a black background
-    window.draw(winnerText);    // Draw the winner text
-    window.draw(scoreText);     // Draw the score text
-    window.display();
-
-    // Pause to allow players to view the winner screen
-    sleep(seconds(5));
-    restart_game(window, game_font); // Restart the game
-    window.close(); // Close the window after displaying the winner
-}
-
-void handleinput(RenderWindow& window) {
+void handleinput() {
     // Adjust paddle speed based on difficulty
     float currentPaddleSpeed = adjust_paddle_speed();
 
@@ -422,559 +507,197 @@ void handleinput(RenderWindow& window) {
 void ai_movement() {
     if (!is_singleplayer || balls.empty()) return; // Return if not single-player or no balls present
 
-    // Get the center positions of the ball and the AI paddle
-    float ballCenter = balls[0].getPosition().y + ballradius;
-    float paddleCenter = right_paddle.getPosition().y + paddleheight / 2.0f;
-
-    // Introduce reaction delay for Easy mode
-    static Clock reactionClock; // Reaction timer
-    float reactionTime = (difficulty == 0) ? 0.01f : 0.03f; // Easy: slower, Medium/Hard: faster
+    // The AI acts once per decision interval (its reaction time, counted in ticks)
+    if (!ai_controller.ready(sim_tick)) {
+        return;
+    }
+    const AiParameters& ai = ai_controller.get_parameters();
+
+    // A trained policy picks up, down or stay at every decision, at the difficulty's speed
+    if (ai_policy.is_loaded()) {
+        float observation[policy_observation_size];
+        capture_match(ai_match);
+        build_observation(ai_match, 1, observation);
+        PolicyAction action = ai_policy.act(observation, ai_policy_buffers);
+        if (action == PolicyMoveDown && right_paddle.getPosition().y + paddleheight < screenheight) {
+            right_paddle.move(0, ai.speed);
+        }
+        else if (action == PolicyMoveUp && right_paddle.getPosition().y > 0) {
+            right_paddle.move(0, -ai.speed);
+        }
+        return;
+    }
 
-    if (reactionClock.getElapsedTime().asSeconds() < reactionTime && difficulty == 0) {
-        return; // Skip movement until reaction time has passed
+    // Expert: whenever a trajectory changed, start a plan on the planner's own threads so
+    // this tick is not held up. Until it is ready (a tick or two) the paddle heads for
+    // the intercept; then it follows the plan. A plan overtaken by another trajectory
+    // change is dropped.
+    if (difficulty == 3) {
+        PaddlePlan plan;
+        if (ai_replan) {
+            ai_plan_ready = false;
+        }
+        if (ai_planner.poll(plan) && !ai_replan) {
+            ai_plan = plan;
+            ai_plan_ready = true;
+        }
+        if (ai_replan && !ai_planner.is_busy()) {
+            LookaheadSettings settings;
+            settings.speed = ai.speed;
+            settings.opponentSpeed = adjust_paddle_speed();
+            capture_match(ai_match);
+            ai_planner.start(ai_match, settings);
+            ai_plan_tick = sim_tick;
+            ai_replan = false;
+        }
+        if (ai_plan_ready && sim_tick < ai_plan_tick + ai_plan.delay) {
+            return; // The plan says wait
+        }
     }
-    if (difficulty == 0) reactionClock.restart();
 
-    // Set AI behavior parameters based on difficulty
-    float speed;
-    float reactionMargin;
-    float predictionError = 0.0f; // Introduce intentional inaccuracy
+    // Aim where the ball will reach the paddle's face. The prediction (and its
+    // misjudgement) is kept until the ball's trajectory changes, so it does not jitter.
+    // With several balls, go for the soonest one the paddle can still reach.
+    float paddleY = right_paddle.getPosition().y;
+    if (difficulty == 3 && ai_plan_ready) {
+        ai_controller.set_target(ai_plan.targetY); // Expert: the planner already chose where to be
+    }
+    else {
+        ai_controller.aim(sim_tick, paddleY, ball_state(0), balls.size(), ai_plane_x());
+    }
 
-    switch (difficulty) {
-    case 0: // Easy
-        speed = 6.0f;
-        reactionMargin = 50.0f;
-        predictionError = 50.0f;
-        break;
-    case 1: // Medium
-        speed = 6.0f;
-        reactionMargin = 20.0f;
-        predictionError = 15.0f;
-        break;
-    case 2: // Hard
-        speed = 8.0f;
-        reactionMargin = 5.0f;
-        predictionError = 5.0f;
-        break;
-    default: // Default to Medium
-        speed = 6.0f;
-        reactionMargin = 20.0f;
-        predictionError = 15.0f;
-        break;
+    // Move the AI paddle within screen boundaries
+    float offset = ai_controller.steer(paddleY);
+    if ((offset > 0 && paddleY + paddleheight < screenheight) || (offset < 0 && paddleY > 0)) {
+        right_paddle.move(0, offset);
     }
+}
 
-    // Add randomness to simulate AI misjudgment
-    ballCenter += (rand() % 2 == 0 ? -predictionError : predictionError);
+float ai_plane_x() {
+    return right_paddle.getPosition().x - 2 * ballradius; // Ball corner x when it touches the paddle's face
+}
 
-    // Move the AI paddle within screen boundaries
-    if (paddleCenter < ballCenter - reactionMargin && right_paddle.getPosition().y + paddleheight < screenheight) {
-        right_paddle.move(0, speed); // Move paddle down
+void track_incoming_balls() {
+    if (!is_singleplayer) {
+        return;
+    }
+
+    // Only paddle hits and goals (which reset the ball) change when a ball arrives;
+    // wall bounces are already folded into the prediction
+    for (const GameEvent& event : tick_events) {
+        if (event.ball >= 0 && event.type != GameEvent::WallBounce) {
+            ai_controller.track(event.ball, ball_state(event.ball), ai_plane_x(), sim_tick);
+            ai_replan = true;
+        }
     }
-    else if (paddleCenter > ballCenter + reactionMargin && right_paddle.getPosition().y > 0) {
-        right_paddle.move(0, -speed); // Move paddle up
+    for (size_t i = ai_controller.get_tracked(); i < balls.size(); ++i) {
+        ai_controller.track(i, ball_state(i), ai_plane_x(), sim_tick); // New balls
+        ai_replan = true;
     }
 }
 
-void check_collisions(RenderWindow& window) {
+void capture_match(MatchState& match) {
+    match.leftPaddleY = left_paddle.getPosition().y;
+    match.rightPaddleY = right_paddle.getPosition().y;
+    match.balls.resize(balls.size()); // Keeps its capacity, so steady-state ticks do not allocate
+    for (size_t i = 0; i < balls.size(); ++i) {
+        match.balls[i] = ball_state(i);
+    }
+    match.leftScore = left_score;
+    match.rightScore = right_score;
+    match.ballSpeed = ball_speed_for(difficulty);
+}
+
+BallState ball_state(size_t index) {
+    BallState ball;
+    ball.x = balls[index].getPosition().x;
+    ball.y = balls[index].getPosition().y;
+    ball.vx = ballSpeedX[index];
+    ball.vy = ballSpeedY[index];
+    return ball;
+}
+
+void check_collisions() {
     for (size_t i = 0; i < balls.size(); ++i) {
         // Ball collision with top and bottom walls
-        if (balls[i].getPosition().y <= 0 || balls[i].getPosition().y + 2 * ballradius >= screenheight) {
+        if (ball_hits_wall(ball_state(i))) {
             ballSpeedY[i] = -ballSpeedY[i]; // Reverse Y direction
+            raise_event(GameEvent::WallBounce, static_cast<int>(i), -1, balls[i].getPosition() + Vector2f(ballradius, ballradius));
         }
 
-        // Ball collision with paddles
-        if (balls[i].getGlobalBounds().intersects(left_paddle.getGlobalBounds())) {
+        // Ball collision with paddles; a hit is raised only on the tick the ball turns around
+        if (ball_overlaps_paddle(ball_state(i), left_paddle.getPosition().x, left_paddle.getPosition().y)) {
+            if (ballSpeedX[i] < 0) {
+                raise_event(GameEvent::PaddleHit, static_cast<int>(i), 0, Vector2f(left_paddle.getPosition().x + paddlewidth, balls[i].getPosition().y + ballradius));
+            }
             ballSpeedX[i] = abs(ballSpeedX[i]); // Bounce right
-            hitSound.play(); // Play hit sound
         }
-        else if (balls[i].getGlobalBounds().intersects(right_paddle.getGlobalBounds())) {
+        else if (ball_overlaps_paddle(ball_state(i), right_paddle.getPosition().x, right_paddle.getPosition().y)) {
+            if (ballSpeedX[i] > 0) {
+                raise_event(GameEvent::PaddleHit, static_cast<int>(i), 1, Vector2f(right_paddle.getPosition().x, balls[i].getPosition().y + ballradius));
+            }
             ballSpeedX[i] = -abs(ballSpeedX[i]); // Bounce left
-            hitSound.play(); // Play hit sound
         }
 
         // Check if ball passes a paddle (score points)
         if (balls[i].getPosition().x <= 0) { // Left wall
             right_score++;
+            raise_event(GameEvent::Goal, static_cast<int>(i), 1, balls[i].getPosition() + Vector2f(ballradius, ballradius));
             reset_ball(i);
         }
         else if (balls[i].getPosition().x + 2 * ballradius >= screenwidth) { // Right wall
             left_score++;
+            raise_event(GameEvent::Goal, static_cast<int>(i), 0, balls[i].getPosition() + Vector2f(ballradius, ballradius));
             reset_ball(i);
         }
-
-        // End the game if the target score is reached
-        if (left_score >= targetscore || right_score >= targetscore) {
-            display_winner(window, left_score >= targetscore ? "Left Player Wins!" : (is_singleplayer ? "AI Wins!" : "Right Player Wins!"), left_score, right_score);
-            return;
-        }
     }
 }
 
-void draw_score(RenderWindow& window, int score, bool isLeft) {
-    Text scoreText;
-    scoreText.setFont(game_font); // Set the font
-    scoreText.setCharacterSize(24); // Set font size
-    scoreText.setFillColor(Color::White); // Set text color
-    scoreText.setString(std::to_string(score)); // Display the score as text
-
-    // Position the score text for left or right player
-    if (isLeft) {
-        scoreText.setPosition(50, 20);
-    }
-    else {
-        scoreText.setPosition(screenwidth - 100, 20);
-    }
-
-    window.draw(scoreText); // Draw the score on the screen
-}
-
-void check_game_end(RenderWindow& window) {
+void check_game_end() {
+    // The one score check per tick, after every ball has moved and scored
     if (!is_timermode) {
-        // End the game based on score
         if (left_score >= targetscore || right_score >= targetscore) {
-            string winner = left_score >= targetscore ? "Player 1 Wins!" : (is_singleplayer ? "AI Wins!" : "Player 2 Wins!");
-            display_winner(window, winner, left_score, right_score);
+            bool leftWins = left_score >= targetscore;
+            end_match(leftWins ? "Left Player Wins!" : (is_singleplayer ? "AI Wins!" : "Right Player Wins!"));
+            raise_event(GameEvent::MatchOver, -1, leftWins ? 0 : 1, Vector2f());
         }
     }
 }
 
 
-void show_mode_selectionwindow(RenderWindow& window, Font& gameFont) {
-    const int screenWidth = 800;
-    const int screenHeight = 600;
-
-    bool isModeSelected = false;
-
-    // Title Text
-    Text titleText;
-    titleText.setFont(gameFont);
-    titleText.setString("Select Mode");
-    titleText.setCharacterSize(50);
-    titleText.setFillColor(Color::White);
-    titleText.setStyle(Text::Bold);
-    titleText.setOutlineColor(Color::Black);
-    titleText.setOutlineThickness(2);
-    titleText.setPosition((screenWidth - titleText.getLocalBounds().width) / 2, 30);
-
-    // Buttons with normal, hover, and click colors
-    struct Button {
-        RectangleShape shape;
-        Text text;
-        Color normalColor;
-        Color hoverColor;
-        Color clickColor;
-        bool isClicked = false;
-    };
-
-    // Single Player Button
-    Button singlePlayerButton;
-    singlePlayerButton.shape = RectangleShape(Vector2f(250, 60));
-    singlePlayerButton.normalColor = Color(50, 70, 120);
-    singlePlayerButton.hoverColor = Color(30, 50, 100);
-    singlePlayerButton.clickColor = Color(20, 40, 80);
-    singlePlayerButton.shape.setFillColor(singlePlayerButton.normalColor);
-    singlePlayerButton.shape.setOutlineColor(Color::White);
-    singlePlayerButton.shape.setOutlineThickness(2);
-    singlePlayerButton.shape.setPosition(screenWidth / 2 - 125, 100);
-    singlePlayerButton.text.setFont(gameFont);
-    singlePlayerButton.text.setString("Single Player");
-    singlePlayerButton.text.setCharacterSize(30);
-    singlePlayerButton.text.setFillColor(Color::White);
-    singlePlayerButton.text.setPosition(singlePlayerButton.shape.getPosition().x + 30, singlePlayerButton.shape.getPosition().y + 10);
-
-    // Multiplayer Button
-    Button multiplayerButton;
-    multiplayerButton.shape = RectangleShape(Vector2f(250, 60));
-    multiplayerButton.normalColor = Color(150, 30, 80);
-    multiplayerButton.hoverColor = Color(120, 20, 60);
-    multiplayerButton.clickColor = Color(100, 10, 40);
-    multiplayerButton.shape.setFillColor(multiplayerButton.normalColor);
-    multiplayerButton.shape.setOutlineColor(Color::White);
-    multiplayerButton.shape.setOutlineThickness(2);
-    multiplayerButton.shape.setPosition(screenWidth / 2 - 125, 180);
-    multiplayerButton.text.setFont(gameFont);
-    multiplayerButton.text.setString("Multiplayer");
-    multiplayerButton.text.setCharacterSize(30);
-    multiplayerButton.text.setFillColor(Color::White);
-    multiplayerButton.text.setPosition(multiplayerButton.shape.getPosition().x + 40, multiplayerButton.shape.getPosition().y + 10);
-
-    // Score Limit Options Title
-    Text scoreLimitTitle;
-    scoreLimitTitle.setFont(gameFont);
-    scoreLimitTitle.setString("Set Score Limit or Timer Mode:");
-    scoreLimitTitle.setCharacterSize(30);
-    scoreLimitTitle.setFillColor(Color::White);
-    scoreLimitTitle.setOutlineColor(Color::Black);
-    scoreLimitTitle.setOutlineThickness(1);
-    scoreLimitTitle.setPosition((screenWidth - scoreLimitTitle.getLocalBounds().width) / 2, 280);
-
-    // Score Limit Buttons
-    Button score15Button;
-    score15Button.shape = RectangleShape(Vector2f(80, 50));
-    score15Button.normalColor = Color(30, 70, 30);
-    score15Button.hoverColor = Color(20, 50, 20);
-    score15Button.clickColor = Color(10, 40, 10);
-    score15Button.shape.setFillColor(score15Button.normalColor);
-    score15Button.shape.setOutlineColor(Color::White);
-    score15Button.shape.setOutlineThickness(2);
-    score15Button.shape.setPosition(screenWidth / 2 - 130, 330);
-    score15Button.text.setFont(gameFont);
-    score15Button.text.setString("15");
-    score15Button.text.setCharacterSize(20);
-    score15Button.text.setFillColor(Color::White);
-    score15Button.text.setPosition(score15Button.shape.getPosition().x + 25, score15Button.shape.getPosition().y + 10);
-
-    Button score25Button;
-    score25Button.shape = RectangleShape(Vector2f(80, 50));
-    score25Button.normalColor = Color(120, 120, 0);
-    score25Button.hoverColor = Color(100, 100, 0);
-    score25Button.clickColor = Color(80, 80, 0);
-    score25Button.shape.setFillColor(score25Button.normalColor);
-    score25Button.shape.setOutlineColor(Color::White);
-    score25Button.shape.setOutlineThickness(2);
-    score25Button.shape.setPosition(screenWidth / 2 - 40, 330);
-    score25Button.text.setFont(gameFont);
-    score25Button.text.setString("25");
-    score25Button.text.setCharacterSize(20);
-    score25Button.text.setFillColor(Color::White);
-    score25Button.text.setPosition(score25Button.shape.getPosition().x + 25, score25Button.shape.getPosition().y + 10);
-
-    Button score40Button;
-    score40Button.shape = RectangleShape(Vector2f(80, 50));
-    score40Button.normalColor = Color(120, 20, 0);
-    score40Button.hoverColor = Color(100, 10, 0);
-    score40Button.clickColor = Color(80, 0, 0);
-    score40Button.shape.setFillColor(score40Button.normalColor);
-    score40Button.shape.setOutlineColor(Color::White);
-    score40Button.shape.setOutlineThickness(2);
-    score40Button.shape.setPosition(screenWidth / 2 + 50, 330);
-    score40Button.text.setFont(gameFont);
-    score40Button.text.setString("40");
-    score40Button.text.setCharacterSize(20);
-    score40Button.text.setFillColor(Color::White);
-    score40Button.text.setPosition(score40Button.shape.getPosition().x + 25, score40Button.shape.getPosition().y + 10);
-
-    Button timerModeButton;
-    timerModeButton.shape = RectangleShape(Vector2f(250, 60));
-    timerModeButton.normalColor = Color(0, 100, 100);
-    timerModeButton.hoverColor = Color(0, 80, 80);
-    timerModeButton.clickColor = Color(0, 60, 60);
-    timerModeButton.shape.setFillColor(timerModeButton.normalColor);
-    timerModeButton.shape.setOutlineColor(Color::White);
-    timerModeButton.shape.setOutlineThickness(2);
-    timerModeButton.shape.setPosition(screenWidth / 2 - 125, 410);
-    timerModeButton.text.setFont(gameFont);
-    timerModeButton.text.setString("Timer Mode");
-    timerModeButton.text.setCharacterSize(30);
-    timerModeButton.text.setFillColor(Color::White);
-    timerModeButton.text.setPosition(timerModeButton.shape.getPosition().x + 40, timerModeButton.shape.getPosition().y + 10);
-
-    auto updateButtonState = [&](Button& button, const Vector2f& mousePos, bool isPressed) {
-        if (button.shape.getGlobalBounds().contains(mousePos)) {
-            button.shape.setFillColor(isPressed ? button.clickColor : button.hoverColor);
-            button.isClicked = isPressed;
-        }
-        else {
-            button.shape.setFillColor(button.normalColor);
-            button.isClicked = false;
-        }
-        };
-
-    while (window.isOpen()) {
-        Event event;
-        Vector2f mousePosition = Vector2f(Mouse::getPosition(window));
-
-        while (window.pollEvent(event)) {
-            if (event.type == Event::Closed) {
-                window.close();
-                return;
-            }
-
-            if (event.type == Event::MouseButtonPressed && event.mouseButton.button == Mouse::Left) {
-                updateButtonState(singlePlayerButton, mousePosition, true);
-                updateButtonState(multiplayerButton, mousePosition, true);
-                updateButtonState(score15Button, mousePosition, true);
-                updateButtonState(score25Button, mousePosition, true);
-                updateButtonState(score40Button, mousePosition, true);
-                updateButtonState(timerModeButton, mousePosition, true);
-
-                if (singlePlayerButton.isClicked) {
-                    is_singleplayer = true;
-                    show_difficulty_window(window, gameFont);
-                    return;
-                }
-                if (multiplayerButton.isClicked) {
-                    is_singleplayer = false;
-                    show_difficulty_window(window, gameFont);
-                    return;
-                }
-                if (score15Button.isClicked) {
-                    is_timermode = false;
-                    targetscore = 15;
-                }
-                if (score25Button.isClicked) {
-                    is_timermode = false;
-                    targetscore = 25;
-                }
-                if (score40Button.isClicked) {
-                    is_timermode = false;
-                    targetscore = 40;
-                }
-                if (timerModeButton.isClicked) {
-                    is_timermode = true;
-                    targetscore = 1000;
-                }
-            }
-
-            if (event.type == Event::MouseButtonReleased && event.mouseButton.button == Mouse::Left) {
-                updateButtonState(singlePlayerButton, mousePosition, false);
-                updateButtonState(multiplayerButton, mousePosition, false);
-                updateButtonState(score15Button, mousePosition, false);
-                updateButtonState(score25Button, mousePosition, false);
-                updateButtonState(score40Button, mousePosition, false);
-                updateButtonState(timerModeButton, mousePosition, false);
-            }
-        }
-
-        updateButtonState(singlePlayerButton, mousePosition, Mouse::isButtonPressed(Mouse::Left));
-        updateButtonState(multiplayerButton, mousePosition, Mouse::isButtonPressed(Mouse::Left));
-        updateButtonState(score15Button, mousePosition, Mouse::isButtonPressed(Mouse::Left));
-        updateButtonState(score25Button, mousePosition, Mouse::isButtonPressed(Mouse::Left));
-        updateButtonState(score40Button, mousePosition, Mouse::isButtonPressed(Mouse::Left));
-        updateButtonState(timerModeButton, mousePosition, Mouse::isButtonPressed(Mouse::Left));
-
-        // Render UI
-        window.clear(Color::Black);
-        window.draw(titleText);
-
-        auto drawButton = [&](Button& button) {
-            window.draw(button.shape);
-            window.draw(button.text);
-            };
-
-        drawButton(singlePlayerButton);
-        drawButton(multiplayerButton);
-        window.draw(scoreLimitTitle);
-        drawButton(score15Button);
-        drawButton(score25Button);
-        drawButton(score40Button);
-        drawButton(timerModeButton);
-
-        window.display();
-    }
-}
-
 void handle_paddle_movement(float paddleSpeed) {
+    // Bring the held keys up to date, keeping taps that were released before this tick
+    bool moving[4];
+    apply_input_events(moving);
+
     // Player 1 paddle controls
     // Move paddle up if 'W' is pressed and it is not at the top of the screen
-    if (Keyboard::isKeyPressed(Keyboard::W) && left_paddle.getPosition().y > 0) {
+    if (moving[0] && left_paddle.getPosition().y > 0) {
         left_paddle.move(0, -paddleSpeed);
     }
     // Move paddle down if 'S' is pressed and it is not at the bottom of the screen
-    if (Keyboard::isKeyPressed(Keyboard::S) && left_paddle.getPosition().y < screenheight - paddleheight) {
+    if (moving[1] && left_paddle.getPosition().y < screenheight - paddleheight) {
         left_paddle.move(0, paddleSpeed);
     }
 
     // Player 2 paddle controls (only in multiplayer mode)
     if (!is_singleplayer) {
         // Move paddle up if 'Up Arrow' is pressed and it is not at the top of the screen
-        if (Keyboard::isKeyPressed(Keyboard::Up) && right_paddle.getPosition().y > 0) {
+        if (moving[2] && right_paddle.getPosition().y > 0) {
             right_paddle.move(0, -paddleSpeed);
         }
         // Move paddle down if 'Down Arrow' is pressed and it is not at the bottom of the screen
-        if (Keyboard::isKeyPressed(Keyboard::Down) && right_paddle.getPosition().y < screenheight - paddleheight) {
+        if (moving[3] && right_paddle.getPosition().y < screenheight - paddleheight) {
             right_paddle.move(0, paddleSpeed);
         }
     }
 }
 
-void show_credits_window(RenderWindow& window, Font& gameFont) {
-    const int screenWidth = 800;
-    const int screenHeight = 600;
-
-    // Setup for the "Back" button
-    RectangleShape backButton(Vector2f(200, 50));
-    backButton.setFillColor(Color(34, 139, 34)); // Dark Green color
-    backButton.setPosition(screenWidth / 2 - 100, screenHeight - 100);
-
-    Text backText;
-    backText.setFont(gameFont);
-    backText.setString("Back");
-    backText.setCharacterSize(30);
-    backText.setFillColor(Color::White);
-    // Center the text within the button
-    backText.setPosition(
-        backButton.getPosition().x + (backButton.getSize().x - backText.getLocalBounds().width) / 2,
-        backButton.getPosition().y + (backButton.getSize().y - backText.getLocalBounds().height) / 4
-    );
-
-    // Title text for the Credits screen
-    Text creditsTitle;
-    creditsTitle.setFont(gameFont);
-    creditsTitle.setString("Credits");
-    creditsTitle.setCharacterSize(50);
-    creditsTitle.setFillColor(Color(135, 206, 250)); // Sky Blue color
-    creditsTitle.setPosition(
-        (screenWidth - creditsTitle.getLocalBounds().width) / 2,
-        50
-    );
-
-    // List of credits
-    Text creditsInfo;
-    creditsInfo.setFont(gameFont);
-    creditsInfo.setString(
-        "Developed by:\n\n"
-        "1. Ahmed Ashraf\n"
-        "2. Muhammad Somaan\n"
-        "3. Ahmed Ali"
-    );
-    creditsInfo.setCharacterSize(35);
-    creditsInfo.setFillColor(Color::White);
-    creditsInfo.setPosition(
-        (screenWidth - creditsInfo.getLocalBounds().width) / 2,
-        150
-    );
-
-    // Decorative horizontal lines
-    RectangleShape topLine(Vector2f(screenWidth - 100, 5));
-    topLine.setFillColor(Color::White);
-    topLine.setPosition(50, 120);
-
-    RectangleShape bottomLine(Vector2f(screenWidth - 100, 5));
-    bottomLine.setFillColor(Color::White);
-    bottomLine.setPosition(50, screenHeight - 150);
-
-    // Event loop to handle interactions on the Credits screen
-    while (window.isOpen()) {
-        Event creditsEvent;
-        while (window.pollEvent(creditsEvent)) {
-            if (creditsEvent.type == Event::Closed) {
-                // Close the window
-                window.close();
-                exit(0);
-            }
-
-            if (creditsEvent.type == Event::MouseButtonPressed && creditsEvent.mouseButton.button == Mouse::Left) {
-                // Check if the "Back" button was clicked
-                Vector2f mousePosition(creditsEvent.mouseButton.x, creditsEvent.mouseButton.y);
-                if (backButton.getGlobalBounds().contains(mousePosition)) {
-                    // Navigate back to the welcome screen
-                    show_welcome_window(window, gameFont);
-                    return;
-                }
-            }
-        }
-
-        // Render the Credits screen
-        window.clear(Color::Black);
-        window.draw(creditsTitle);
-        window.draw(topLine);
-        window.draw(creditsInfo);
-        window.draw(bottomLine);
-        window.draw(backButton);
-        window.draw(backText);
-        window.display();
-    }
-}
-
-void show_welcome_window(RenderWindow& window, Font& gameFont) {
-    const int screenWidth = 800;
-    const int screenHeight = 600;
-
-    // Title text setup
-    Text titleText;
-    titleText.setFont(gameFont);
-    titleText.setString("Pong Game");
-    titleText.setCharacterSize(70);
-    titleText.setFillColor(Color::White);
-    FloatRect titleBounds = titleText.getLocalBounds();
-    titleText.setPosition((screenWidth - titleBounds.width) / 2, 100);
-
-    // Buttons for Play, Exit, and Credits
-    RectangleShape playButton(Vector2f(200, 50));
-    playButton.setFillColor(Color::Green);
-    playButton.setPosition(screenWidth / 2 - 100, screenHeight / 2 - 70);
-
-    Text playText;
-    playText.setFont(gameFont);
-    playText.setString("Play");
-    playText.setCharacterSize(30);
-    playText.setFillColor(Color::White);
-    playText.setPosition(playButton.getPosition().x + 70, playButton.getPosition().y + 5);
-
-    RectangleShape exitButton(Vector2f(200, 50));
-    exitButton.setFillColor(Color::Red);
-    exitButton.setPosition(screenWidth / 2 - 100, screenHeight / 2 + 20);
-
-    Text exitText;
-    exitText.setFont(gameFont);
-    exitText.setString("Exit");
-    exitText.setCharacterSize(30);
-    exitText.setFillColor(Color::White);
-    exitText.setPosition(exitButton.getPosition().x + 70, exitButton.getPosition().y + 5);
-
-    RectangleShape creditsButton(Vector2f(200, 50));
-    creditsButton.setFillColor(Color::Blue);
-    creditsButton.setPosition(screenWidth / 2 - 100, screenHeight / 2 + 110);
-
-    Text creditsText;
-    creditsText.setFont(gameFont);
-    creditsText.setString("Credits");
-    creditsText.setCharacterSize(30);
-    creditsText.setFillColor(Color::White);
-    creditsText.setPosition(creditsButton.getPosition().x + 45, creditsButton.getPosition().y + 5);
-
-    // Event loop to handle Welcome screen interactions
-    while (window.isOpen()) {
-        Event event;
-        while (window.pollEvent(event)) {
-            if (event.type == Event::Closed) {
-                window.close();
-                exit(0);
-            }
-
-            if (event.type == Event::MouseButtonPressed && event.mouseButton.button == Mouse::Left) {
-                Vector2f mousePosition(event.mouseButton.x, event.mouseButton.y);
-
-                // Check which button was clicked
-                if (playButton.getGlobalBounds().contains(mousePosition)) {
-                    show_mode_selectionwindow(window, gameFont);
-                    return;
-                }
-                if (exitButton.getGlobalBounds().contains(mousePosition)) {
-                    window.close();
-                    exit(0);
-                }
-                if (creditsButton.getGlobalBounds().contains(mousePosition)) {
-                    show_credits_window(window, gameFont);
-                    return;
-                }
-            }
-        }
-
-        // Button hover effects
-        Vector2f mousePosition(Mouse::getPosition(window).x, Mouse::getPosition(window).y);
-        playButton.setFillColor(playButton.getGlobalBounds().contains(mousePosition) ? Color::Yellow : Color::Green);
-        exitButton.setFillColor(exitButton.getGlobalBounds().contains(mousePosition) ? Color::Magenta : Color::Red);
-        creditsButton.setFillColor(creditsButton.getGlobalBounds().contains(mousePosition) ? Color::Cyan : Color::Blue);
-
-        // Render Welcome screen
-        window.clear();
-        window.draw(titleText);
-        window.draw(playButton);
-        window.draw(playText);
-        window.draw(exitButton);
-        window.draw(exitText);
-        window.draw(creditsButton);
-        window.draw(creditsText);
-        window.display();
-    }
-}
-
 void restart_game(RenderWindow& window, Font& gameFont) {
     // Reset Timer Mode and clock
     is_timermode = false;
-    game_clock.restart();
+    sim_tick = 0;
+    match_over = false;
 
     // Reset paddle positions
     left_paddle.setPosition(30, 250);
@@ -998,3 +721,238 @@ void restart_game(RenderWindow& window, Font& gameFont) {
 
 
 }
+
+void end_match(const string& winner) {
+    // Keep the first result; later checks in the same tick must not overwrite it
+    if (!match_over) {
+        match_over = true;
+        match_winner = winner;
+    }
+}
+
+void raise_event(GameEvent::Type type, int ball, int side, Vector2f position) {
+    GameEvent event;
+    event.type = type;
+    event.tick = sim_tick;
+    event.ball = ball;
+    event.side = side;
+    event.position = position;
+    if (ball >= 0) {
+        event.speed = sqrt(ballSpeedX[ball] * ballSpeedX[ball] + ballSpeedY[ball] * ballSpeedY[ball]);
+    }
+    tick_events.push(event);
+
+    LOG_DEBUG("tick %llu: %s (ball %d, side %d)", static_cast<unsigned long long>(sim_tick), event_name(type), ball, side);
+}
+
+bool effect_for(const GameEvent& event, EffectRequest& effect) {
+    effect.position = event.position;
+    switch (event.type) {
+    case GameEvent::PaddleHit:
+        effect.type = EffectRequest::PaddleSpark;
+        effect.directionX = event.side == 0 ? 1.0f : -1.0f; // Sparks fly back into the field
+        return true;
+    case GameEvent::Goal:
+        effect.type = EffectRequest::GoalBurst;
+        effect.directionX = event.side == 0 ? -1.0f : 1.0f; // Away from the wall the ball went through
+        return true;
+    default:
+        return false;
+    }
+}
+
+void capture_snapshot(GameSnapshot& snapshot) {
+    snapshot.tick = sim_tick;
+    snapshot.published = chrono::steady_clock::now();
+    snapshot.leftPaddle = left_paddle.getPosition();
+    snapshot.rightPaddle = right_paddle.getPosition();
+
+    // resize() keeps the slot's capacity, so steady-state ticks do not allocate
+    snapshot.balls.resize(balls.size());
+    for (size_t i = 0; i < balls.size(); ++i) {
+        snapshot.balls[i] = balls[i].getPosition();
+    }
+
+    snapshot.leftScore = left_score;
+    snapshot.rightScore = right_score;
+    snapshot.targetScore = targetscore;
+    snapshot.timerMode = is_timermode;
+    snapshot.remainingTime = time_limit - static_cast<int>(sim_tick / sim_tickrate);
+    snapshot.matchOver = match_over;
+    snapshot.winner = match_winner;
+}
+
+void simulate_tick() {
+    // Timer Mode logic
+    if (is_timermode) {
+        int remainingTime = time_limit - static_cast<int>(sim_tick / sim_tickrate);
+        if (remainingTime <= 0) { // If time is up
+            string winner;
+            if (left_score > right_score) {
+                winner = "Left Player Wins!";
+            }
+            else if (right_score > left_score) {
+                winner = is_singleplayer ? "Left Player Wins" : "AI Wins!";
+            }
+            else {
+                winner = "It's a Tie!";
+            }
+
+            end_match(winner);
+            raise_event(GameEvent::MatchOver, -1, left_score > right_score ? 0 : (right_score > left_score ? 1 : -1), Vector2f());
+            return; // End the game
+        }
+    }
+
+    // Handle input and game logic
+    handleinput();
+
+    // Update ball movement and speed
+    for (size_t i = 0; i < balls.size(); ++i) {
+        adjust_ballspeed(i); // Adjust speed dynamically
+        balls[i].move(ballSpeedX[i], ballSpeedY[i]); // Move ball
+    }
+
+    // Check collisions and game end conditions
+    check_collisions();
+    track_incoming_balls();
+    check_game_end();
+}
+
+void simulation_thread() {
+    const auto maxLag = chrono::milliseconds(250); // Give up catching up after a long stall
+    auto nextTick = chrono::steady_clock::now();
+
+    while (sim_running && !match_over) {
+        tick_events.clear();
+        simulate_tick();
+        ++sim_tick;
+
+        // Hand the tick's events over as one batch; if the render thread falls far behind, the extras are dropped
+        for (const GameEvent& event : tick_events) {
+            if (!event_queue.push(event)) {
+                ++events_undelivered;
+            }
+        }
+
+        // Publish the finished tick; the render thread never waits on this
+        capture_snapshot(snapshots.write_buffer());
+        snapshots.publish();
+
+        // Sleep until the next tick is due, skipping ahead instead of spiralling after a stall
+        nextTick += sim_tick_duration;
+        auto now = chrono::steady_clock::now();
+        if (now - nextTick > maxLag) {
+            LOG_WARNING("Simulation stalled for %lld ms; skipping ahead",
+                static_cast<long long>(chrono::duration_cast<chrono::milliseconds>(now - nextTick).count()));
+            nextTick = now;
+        }
+        this_thread::sleep_until(nextTick);
+    }
+}
+
+bool pump_events(RenderWindow& window, RenderScaler& scaler, FramePacer& pacer) {
+    bool paddleInput = false;
+    Event event;
+    while (window.pollEvent(event)) {
+        if (event.type == Event::Closed)
+            window.close(); // Close window if the user exits
+
+        // Pass paddle key transitions to the simulation in order, so a quick tap is not lost
+        key_state.on_event(event);
+        if (event.type == Event::KeyPressed || event.type == Event::KeyReleased) {
+            for (Keyboard::Key key : paddle_keys) {
+                if (event.key.code == key) {
+                    InputEvent input;
+                    input.key = key;
+                    input.pressed = event.type == Event::KeyPressed;
+                    input_queue.push(input);
+                    paddleInput = true;
+                }
+            }
+        }
+        else if (event.type == Event::LostFocus) {
+            // KeyState released everything; tell the simulation too
+            for (Keyboard::Key key : paddle_keys) {
+                InputEvent input;
+                input.key = key;
+                input.pressed = false;
+                input_queue.push(input);
+            }
+        }
+
+        // Render-scale hotkeys: F2 cycles the playfield resolution, F3 toggles filtering
+        if (event.type == Event::KeyPressed && event.key.code == Keyboard::F2) {
+            scaler.cycle_scale();
+            LOG_INFO("Render scale: %g", scaler.get_scale());
+        }
+        if (event.type == Event::KeyPressed && event.key.code == Keyboard::F3) {
+            scaler.set_smooth(!scaler.is_smooth());
+            LOG_INFO("Render filter: %s", scaler.is_smooth() ? "linear" : "nearest");
+        }
+
+        // F4 cycles the frame rate cap: 60, 120, 144, 240, uncapped
+        if (event.type == Event::KeyPressed && event.key.code == Keyboard::F4) {
+            const int rates[] = { 60, 120, 144, 240, 0 };
+            int next = 0;
+            for (int r = 0; r < 5; ++r) {
+                if (rates[r] == pacer.get_target()) {
+                    next = (r + 1) % 5;
+                }
+            }
+            pacer.set_target(rates[next]);
+            pacer.reset_stats();
+            if (rates[next] > 0) {
+                LOG_INFO("Frame rate cap: %d Hz", rates[next]);
+            }
+            else {
+                LOG_INFO("Frame rate cap: uncapped");
+            }
+        }
+    }
+    return paddleInput;
+}
+
+void apply_input_events(bool (&moving)[4]) {
+    // A key moves its paddle this tick if it is held now or was pressed since the last
+    // tick, so a press and release that arrive together still move it one tick
+    for (bool& move : moving) {
+        move = false;
+    }
+    InputEvent input;
+    while (input_queue.pop(input)) {
+        int index = 0;
+        while (index < 4 && paddle_keys[index] != input.key) {
+            ++index;
+        }
+        if (index == 4 || paddle_key_held[index] == input.pressed) {
+            continue; // Not a paddle key, or no change (e.g. a release after losing focus)
+        }
+        paddle_key_held[index] = input.pressed;
+        moving[index] = moving[index] || input.pressed;
+    }
+    for (int i = 0; i < 4; ++i) {
+        moving[i] = moving[i] || paddle_key_held[i];
+    }
+}
+
+LatchedPaddles latch_paddles(const GameSnapshot& snapshot) {
+    // Ticks the simulation is ahead of the snapshot, bounded so a stall cannot fling the paddle
+    float ticksAhead = chrono::duration<float>(chrono::steady_clock::now() - snapshot.published) / sim_tick_duration;
+    ticksAhead = min(max(ticksAhead, 0.0f), sim_tickrate / 20.0f);
+    float step = adjust_paddle_speed() * ticksAhead;
+
+    auto extrapolate = [step](float y, bool up, bool down) {
+        y += (down ? step : 0.0f) - (up ? step : 0.0f);
+        return min(max(y, 0.0f), screenheight - paddleheight);
+        };
+
+    LatchedPaddles latched;
+    latched.left = true;
+    latched.leftY = extrapolate(snapshot.leftPaddle.y, key_state.is_down(Keyboard::W), key_state.is_down(Keyboard::S));
+    if (!is_singleplayer) {
+        latched.right = true;
+        latched.rightY = extrapolate(snapshot.rightPaddle.y, key_state.is_down(Keyboard::Up), key_state.is_down(Keyboard::Down));
+    }
+    return latched;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <atomic>
+
+// Lock-free single-producer / single-consumer triple buffer.
+// The writer always has a private slot to fill, the reader always has a private
+// slot to read, and the third slot is handed over through one atomic exchange,
+// so neither side ever waits for the other. Slots are reused, which means a
+// writer that only assigns into its slot stops allocating once warmed up.
+template <typename T>
+class TripleBuffer {
+public:
+    // Slot owned by the writer until the next publish()
+    T& write_buffer() { return slots[backIndex]; }
+
+    // Hands the write slot to the reader and takes the spare one back
+    void publish() {
+        backIndex = middle.exchange(backIndex | fresh_bit, std::memory_order_acq_rel) & index_mask;
+    }
+
+    // Swaps in the newest published slot; returns false if nothing new arrived
+    bool update() {
+        if ((middle.load(std::memory_order_acquire) & fresh_bit) == 0) {
+            return false;
+        }
+        frontIndex = middle.exchange(frontIndex, std::memory_order_acq_rel) & index_mask;
+        return true;
+    }
+
+    // Slot owned by the reader until the next successful update()
+    const T& read_buffer() const { return slots[frontIndex]; }
+
+private:
+    static const unsigned index_mask = 3u; // Low bits hold the slot index
+    static const unsigned fresh_bit = 4u;  // Set while the middle slot holds unread data
+
+    T slots[3];
+    unsigned backIndex = 0;                // Writer's slot
+    std::atomic<unsigned> middle{ 1u };    // Slot in transit between the two sides
+    unsigned frontIndex = 2;               // Reader's slot
+};
@@ -0,0 +1,167 @@
+#include "widgets.h"
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+using namespace sf;
+
+void ButtonPanel::build(const Font& font, const ButtonSpec* specs, size_t count) {
+    this->font = &font;
+    this->specs.assign(specs, specs + count);
+    hitRects.clear();
+    fillVertex.clear();
+    states.assign(count, 0);
+    pointer = Vector2f(-1.0f, -1.0f);
+    pointerDown = false;
+    rectVertices.clear();
+    labelBatches.clear();
+
+    for (size_t i = 0; i < count; ++i) {
+        const ButtonSpec& spec = specs[i];
+        const float outline = spec.outlineThickness;
+        FloatRect outer(spec.rect.left - outline, spec.rect.top - outline,
+            spec.rect.width + 2 * outline, spec.rect.height + 2 * outline);
+        hitRects.push_back(outer);
+
+        // Outline first, then the fill on top of it
+        if (outline > 0.0f) {
+            add_quad(rectVertices, outer, Color::White);
+        }
+        fillVertex.push_back(rectVertices.size());
+        add_quad(rectVertices, spec.rect, spec.normalColor);
+
+        add_label(spec);
+    }
+}
+
+int ButtonPanel::hit_test(const Vector2f& point) const {
+    for (size_t i = 0; i < hitRects.size(); ++i) {
+        if (hitRects[i].contains(point)) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+int ButtonPanel::clicked(const Event& event) const {
+    if (event.type != Event::MouseButtonPressed || event.mouseButton.button != Mouse::Left) {
+        return -1;
+    }
+    return hit_test(Vector2f(static_cast<float>(event.mouseButton.x), static_cast<float>(event.mouseButton.y)));
+}
+
+bool ButtonPanel::track_pointer(const Event& event) {
+    switch (event.type) {
+    case Event::MouseMoved:
+        pointer = Vector2f(static_cast<float>(event.mouseMove.x), static_cast<float>(event.mouseMove.y));
+        break;
+    case Event::MouseLeft:
+        pointer = Vector2f(-1.0f, -1.0f);
+        break;
+    case Event::MouseButtonPressed:
+    case Event::MouseButtonReleased:
+        if (event.mouseButton.button != Mouse::Left) {
+            return false;
+        }
+        pointer = Vector2f(static_cast<float>(event.mouseButton.x), static_cast<float>(event.mouseButton.y));
+        pointerDown = event.type == Event::MouseButtonPressed;
+        break;
+    default:
+        return false;
+    }
+    return update_colors();
+}
+
+bool ButtonPanel::reset_pointer(const Vector2f& point) {
+    pointer = point;
+    pointerDown = false;
+    return update_colors();
+}
+
+bool ButtonPanel::update_colors() {
+    const int hit = hit_test(pointer);
+    bool changed = false;
+    for (size_t i = 0; i < specs.size(); ++i) {
+        int state = static_cast<int>(i) == hit ? (pointerDown ? 2 : 1) : 0;
+        if (state == states[i]) {
+            continue;
+        }
+        states[i] = state;
+        const Color& color = state == 2 ? specs[i].clickColor : state == 1 ? specs[i].hoverColor : specs[i].normalColor;
+        for (size_t v = fillVertex[i]; v < fillVertex[i] + 4; ++v) {
+            rectVertices[v].color = color;
+        }
+        changed = true;
+    }
+    return changed;
+}
+
+void ButtonPanel::draw(RenderTarget& target) const {
+    if (!rectVertices.empty()) {
+        target.draw(rectVertices.data(), rectVertices.size(), Quads);
+    }
+    for (const LabelBatch& batch : labelBatches) {
+        RenderStates states;
+        states.texture = &font->getTexture(batch.characterSize);
+        target.draw(batch.vertices.data(), batch.vertices.size(), Quads, states);
+    }
+}
+
+void ButtonPanel::add_quad(vector<Vertex>& vertices, const FloatRect& rect, const Color& color, const FloatRect& texture) {
+    const float right = rect.left + rect.width, bottom = rect.top + rect.height;
+    const float u2 = texture.left + texture.width, v2 = texture.top + texture.height;
+    vertices.push_back(Vertex(Vector2f(rect.left, rect.top), color, Vector2f(texture.left, texture.top)));
+    vertices.push_back(Vertex(Vector2f(right, rect.top), color, Vector2f(u2, texture.top)));
+    vertices.push_back(Vertex(Vector2f(right, bottom), color, Vector2f(u2, v2)));
+    vertices.push_back(Vertex(Vector2f(rect.left, bottom), color, Vector2f(texture.left, v2)));
+}
+
+void ButtonPanel::add_label(const ButtonSpec& spec) {
+    // Lay the label out the way sf::Text does: baseline one character size below
+    // the position, glyphs advanced with kerning, quads padded by one pixel
+    const unsigned int size = spec.characterSize;
+    const float padding = 1.0f;
+    LabelBatch& batch = batch_for(size);
+    const size_t first = batch.vertices.size();
+
+    float x = 0.0f, minX = numeric_limits<float>::max(), maxX = -numeric_limits<float>::max();
+    Uint32 previous = 0;
+    for (const char* c = spec.label; *c; ++c) {
+        Uint32 current = static_cast<unsigned char>(*c);
+        x += font->getKerning(previous, current, size);
+        previous = current;
+
+        const Glyph& glyph = font->getGlyph(current, size, false);
+        if (current != ' ') {
+            FloatRect bounds(x + glyph.bounds.left - padding, static_cast<float>(size) + glyph.bounds.top - padding,
+                glyph.bounds.width + 2 * padding, glyph.bounds.height + 2 * padding);
+            FloatRect texture(glyph.textureRect.left - padding, glyph.textureRect.top - padding,
+                glyph.textureRect.width + 2 * padding, glyph.textureRect.height + 2 * padding);
+            add_quad(batch.vertices, bounds, spec.textColor, texture);
+            minX = min(minX, x + glyph.bounds.left);
+            maxX = max(maxX, x + glyph.bounds.left + glyph.bounds.width);
+        }
+        x += glyph.advance;
+    }
+
+    // Move the run into place now that its width is known
+    if (minX > maxX) {
+        minX = maxX = 0.0f; // Only spaces
+    }
+    float offsetX = spec.labelOffset.x == center_label ? (spec.rect.width - (maxX - minX)) / 2 - minX : spec.labelOffset.x;
+    Vector2f origin(spec.rect.left + offsetX, spec.rect.top + spec.labelOffset.y);
+    for (size_t v = first; v < batch.vertices.size(); ++v) {
+        batch.vertices[v].position += origin;
+    }
+}
+
+ButtonPanel::LabelBatch& ButtonPanel::batch_for(unsigned int characterSize) {
+    for (LabelBatch& batch : labelBatches) {
+        if (batch.characterSize == characterSize) {
+            return batch;
+        }
+    }
+    labelBatches.push_back(LabelBatch());
+    labelBatches.back().characterSize = characterSize;
+    return labelBatches.back();
+}
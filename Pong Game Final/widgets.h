@@ -0,0 +1,62 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <vector>
+
+// Places a button label centered horizontally instead of at a fixed x offset
+const float center_label = -1.0f;
+
+// One row of a screen's button table
+struct ButtonSpec {
+    const char* label;
+    sf::FloatRect rect;         // Button area in window coordinates, without the outline
+    unsigned int characterSize;
+    sf::Color normalColor;
+    sf::Color hoverColor;
+    sf::Color clickColor;
+    sf::Color textColor;
+    float outlineThickness;     // White outline around the button; 0 for none
+    sf::Vector2f labelOffset;   // Label position from the button's corner (x may be center_label)
+};
+
+// The buttons of one screen, built once from a ButtonSpec table. Every button
+// rectangle goes into one vertex batch and every label into one glyph batch per
+// character size, so a screen costs a few draw calls however many buttons it has.
+// Hit testing runs over a precomputed rect array, and hover or click feedback
+// only recolors the affected vertices.
+class ButtonPanel {
+public:
+    void build(const sf::Font& font, const ButtonSpec* specs, std::size_t count);
+
+    int hit_test(const sf::Vector2f& point) const;                // Index of the button under point, or -1
+    int clicked(const sf::Event& event) const;                    // Button a left click landed on, or -1
+    bool track_pointer(const sf::Event& event);                   // Follows mouse events; true if any color changed
+    bool reset_pointer(const sf::Vector2f& point);                // Hover state when the screen is shown again
+    void draw(sf::RenderTarget& target) const;
+
+    std::size_t size() const { return hitRects.size(); }
+    unsigned int get_draw_calls() const { return static_cast<unsigned int>(1 + labelBatches.size()); }
+
+private:
+    struct LabelBatch {
+        unsigned int characterSize;
+        std::vector<sf::Vertex> vertices;  // Glyph quads textured from the font page of this size
+    };
+
+    bool update_colors();                                         // Recolors fills from the pointer; true if any changed
+    void add_quad(std::vector<sf::Vertex>& vertices, const sf::FloatRect& rect, const sf::Color& color,
+        const sf::FloatRect& texture = sf::FloatRect());
+    void add_label(const ButtonSpec& spec);
+    LabelBatch& batch_for(unsigned int characterSize);
+
+    const sf::Font* font = nullptr;
+    std::vector<ButtonSpec> specs;
+    std::vector<sf::FloatRect> hitRects;   // Including the outline, as getGlobalBounds() would report
+    std::vector<std::size_t> fillVertex;   // First vertex of each button's fill quad
+    std::vector<int> states;               // 0 = normal, 1 = hover, 2 = pressed, per button
+    sf::Vector2f pointer{ -1.0f, -1.0f };  // Last known mouse position
+    bool pointerDown = false;              // Left button held
+    std::vector<sf::Vertex> rectVertices;  // Outline and fill quads for every button
+    std::vector<LabelBatch> labelBatches;
+};
@@ -0,0 +1,206 @@
+// Headless rendering benchmark.
+// Renders synthetic game states into an off-screen RenderTexture and reports, for
+// every rendering path, frames per second, draw calls per frame and the CPU time
+// spent building and submitting a frame. Run it on the target machine (e.g. a
+// llvmpipe kiosk) to compare batching and render-scale options between builds.
+//
+// Usage: "Pong Render Bench" [--seconds <s>] [--max-balls <n>] [--font <path>]
+
+#include <SFML/Graphics.hpp>
+#include <SFML/OpenGL.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "game_constants.h"
+#include "game_render.h"
+#include "game_snapshot.h"
+#include "menus.h"
+#include "particles.h"
+#include "render_scale.h"
+#include "soft_raster.h"
+
+using namespace std;
+using namespace sf;
+
+namespace {
+    typedef chrono::steady_clock bench_clock;
+
+    struct BenchResult {
+        int frames = 0;
+        double wallSeconds = 0.0;    // Including waiting for the GPU to finish
+        double cpuSeconds = 0.0;     // Building and submitting draw calls only
+        unsigned int drawCalls = 0;  // Per frame
+    };
+
+    // Runs frame() repeatedly for about the given time (at least three frames).
+    // frame() returns the number of draw calls it issued.
+    template <typename Frame>
+    BenchResult run_path(RenderTexture& target, double seconds, Frame frame) {
+        // Warm up caches, glyph atlases and driver state
+        for (int i = 0; i < 3; ++i) {
+            frame(i);
+            target.display();
+        }
+        glFinish();
+
+        BenchResult result;
+        auto start = bench_clock::now();
+        do {
+            auto cpuStart = bench_clock::now();
+            result.drawCalls = frame(result.frames);
+            target.display();
+            result.cpuSeconds += chrono::duration<double>(bench_clock::now() - cpuStart).count();
+            glFinish(); // Count the GPU (or llvmpipe) work too, one frame at a time
+            ++result.frames;
+            result.wallSeconds = chrono::duration<double>(bench_clock::now() - start).count();
+        } while (result.wallSeconds < seconds || result.frames < 3);
+        return result;
+    }
+
+    void report(const string& path, size_t balls, const BenchResult& result) {
+        printf("%-28s %8zu %10.1f %10u %12.3f\n", path.c_str(), balls,
+            result.frames / result.wallSeconds, result.drawCalls,
+            1000.0 * result.cpuSeconds / result.frames);
+        fflush(stdout);
+    }
+
+    // A mid-match state with the given number of balls spread over the playfield
+    void make_state(GameSnapshot& previous, GameSnapshot& current, size_t ballCount, mt19937& rng) {
+        uniform_real_distribution<float> x(0.0f, screenwidth - 2 * ballradius);
+        uniform_real_distribution<float> y(0.0f, screenheight - 2 * ballradius);
+
+        current = GameSnapshot();
+        current.leftPaddle = Vector2f(50.0f, 180.0f);
+        current.rightPaddle = Vector2f(screenwidth - 50.0f - paddlewidth, 320.0f);
+        current.leftScore = 7;
+        current.rightScore = 11;
+        current.targetScore = 15;
+        current.timerMode = true;
+        current.remainingTime = 42;
+        current.balls.resize(ballCount);
+        for (auto& ball : current.balls) {
+            ball = Vector2f(x(rng), y(rng));
+        }
+
+        // The previous tick is one step behind, so interpolation does real work
+        previous = current;
+        for (auto& ball : previous.balls) {
+            ball -= Vector2f(1.0f, 1.0f);
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    double seconds = 1.0;
+    size_t maxBalls = 100000;
+    string fontPath = "Arial.ttf";
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--max-balls") == 0 && i + 1 < argc) {
+            maxBalls = static_cast<size_t>(atol(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--font") == 0 && i + 1 < argc) {
+            fontPath = argv[++i];
+        }
+    }
+
+    Font font;
+    if (!font.loadFromFile(fontPath) && !font.loadFromFile("../Pong Game Final/Arial.ttf")) {
+        printf("Error: Could not load font (use --font <path>)\n");
+        return -1;
+    }
+
+    RenderTexture target;
+    if (!target.create(screenwidth, screenheight)) {
+        printf("Error: Could not create a %dx%d render texture\n", screenwidth, screenheight);
+        return -1;
+    }
+    target.setActive(true);
+    printf("GL renderer: %s\n\n", reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+    printf("%-28s %8s %10s %10s %12s\n", "path", "balls", "fps", "draws", "cpu ms/frame");
+
+    RenderScaler scaler(screenwidth, screenheight);
+    GameRenderer renderer(font, scaler);
+    mt19937 rng(1234);
+    GameSnapshot previous, current;
+
+    // Playfield + HUD for every ball count, ball path and render scale
+    for (size_t balls = 1; balls <= maxBalls; balls *= 10) {
+        make_state(previous, current, balls, rng);
+        for (int batched = 0; batched <= 1; ++batched) {
+            for (float scale : { 1.0f, 0.5f }) {
+                renderer.set_batch_balls(batched != 0);
+                scaler.set_scale(scale);
+                BenchResult result = run_path(target, seconds, [&](int) {
+                    renderer.draw(target, previous, current, 0.5f, nullptr);
+                    return renderer.get_draw_calls();
+                    });
+                report(string(batched ? "game/batched" : "game/shapes") + (scale < 1.0f ? "@0.5" : "@1.0"), balls, result);
+            }
+        }
+    }
+    scaler.set_scale(1.0f);
+
+    // HUD only: cached score and timer text
+    make_state(previous, current, 0, rng);
+    report("hud", 0, run_path(target, seconds, [&](int frame) {
+        target.clear(Color::Black);
+        current.remainingTime = 60 - frame % 60; // Re-lay out the timer text once per "second"
+        renderer.draw_hud(target, current);
+        return renderer.get_draw_calls();
+        }));
+
+    // A full particle pool on top of the playfield
+    ParticleSystem particles(4096);
+    EffectRequest burst;
+    burst.type = EffectRequest::GoalBurst;
+    burst.position = Vector2f(screenwidth / 2.0f, screenheight / 2.0f);
+    while (particles.size() < particles.get_capacity()) {
+        particles.spawn(burst);
+    }
+    particles.update(0.0f);
+    report("game/particles-4096", 0, run_path(target, seconds, [&](int) {
+        renderer.draw(target, previous, current, 0.5f, &particles);
+        return renderer.get_draw_calls();
+        }));
+
+    // Menus: the mode selection screen exactly as show_mode_selectionwindow() draws it
+    ModeSelectionScreen modeScreen;
+    build_mode_selection_screen(modeScreen, font);
+    report("menu/mode-selection", 0, run_path(target, seconds, [&](int) {
+        target.clear(Color::Black);
+        draw_mode_selection_screen(target, modeScreen);
+        return 2 + modeScreen.buttons.get_draw_calls(); // Title, subtitle, then the button batches
+        }));
+
+    // For reference: the CPU rasterizer at observation size, no GL involved
+    {
+        make_state(previous, current, 1, rng);
+        vector<uint8_t> pixels(84 * 84 * 3);
+        RasterTarget observation;
+        observation.pixels = pixels.data();
+        observation.width = 84;
+        observation.height = 84;
+        observation.format = PixelFormat::RGB24;
+
+        BenchResult result;
+        auto start = bench_clock::now();
+        do {
+            for (int i = 0; i < 1000; ++i) {
+                rasterize_snapshot(current, observation);
+            }
+            result.frames += 1000;
+            result.wallSeconds = chrono::duration<double>(bench_clock::now() - start).count();
+        } while (result.wallSeconds < seconds);
+        result.cpuSeconds = result.wallSeconds;
+        report("cpu-raster/84x84-rgb", 1, result);
+    }
+
+    return 0;
+}